@@ -0,0 +1,161 @@
+#include "BlockTimeRecorder.h"
+#include <algorithm>
+
+const char *BlockTimeRecorder::getModuleName(int bit) {
+  static const char *const names[NumModules] = {
+      "gate", "drive", "pitch", "echo", "reverb", "width", "instrument",
+      "analyzer"};
+  return (bit >= 0 && bit < NumModules) ? names[bit] : "";
+}
+
+void BlockTimeRecorder::setParameters(
+    const juce::Array<juce::AudioProcessorParameter *> &params) {
+  parameters.assign(params.begin(), params.end());
+  lastValues.resize(parameters.size());
+  for (size_t i = 0; i < parameters.size(); ++i)
+    lastValues[i] = parameters[i]->getValue();
+}
+
+void BlockTimeRecorder::beginBlock() {
+  current.events = pendingEvents.exchange(0, std::memory_order_relaxed);
+  current.numParamChanges = 0;
+
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    const float value = parameters[i]->getValue();
+    if (value == lastValues[i])
+      continue;
+
+    lastValues[i] = value;
+    if (current.numParamChanges < kMaxParamChanges)
+      current.paramChanges[(size_t)current.numParamChanges] = (juce::int16)i;
+    ++current.numParamChanges;
+  }
+}
+
+void BlockTimeRecorder::endBlock(float cpuSeconds, int numSamples,
+                                 double sampleRate, juce::uint32 modules,
+                                 int quality) {
+  if (numSamples <= 0 || sampleRate <= 0.0)
+    return;
+
+  const float load =
+      (float)((double)cpuSeconds * sampleRate / (double)numSamples);
+  const auto blockIndex = numBlocks.fetch_add(1, std::memory_order_relaxed);
+
+  const int bin = juce::jlimit(0, kNumBins - 1, (int)(load / kBinWidth));
+  histogram[(size_t)bin].fetch_add(1, std::memory_order_relaxed);
+  if (load >= 1.0f)
+    deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+
+  if (load <= slowest[(size_t)fastestSlot].load)
+    return;
+
+  current.load = load;
+  current.cpuSeconds = cpuSeconds;
+  current.numSamples = numSamples;
+  current.sampleRate = sampleRate;
+  current.blockIndex = (juce::int64)blockIndex;
+  current.timeMillis = juce::Time::currentTimeMillis();
+  current.modules = modules;
+  current.quality = quality;
+
+  const auto seq = sequence.load(std::memory_order_relaxed);
+  sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slowest[(size_t)fastestSlot] = current;
+  sequence.store(seq + 2, std::memory_order_release);
+
+  for (int i = 0; i < kNumSlowest; ++i)
+    if (slowest[(size_t)i].load < slowest[(size_t)fastestSlot].load)
+      fastestSlot = i;
+}
+
+std::vector<BlockTimeRecorder::SlowBlock>
+BlockTimeRecorder::getSlowestBlocks() const {
+  std::vector<SlowBlock> blocks(slowest.size());
+
+  for (;;) {
+    const auto before = sequence.load(std::memory_order_acquire);
+    if ((before & 1u) == 0) {
+      std::copy(slowest.begin(), slowest.end(), blocks.begin());
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) == before)
+        break;
+    }
+    juce::Thread::yield();
+  }
+
+  // Unused slots
+  blocks.erase(
+      std::remove_if(blocks.begin(), blocks.end(),
+                     [](const SlowBlock &b) { return b.load <= 0.0f; }),
+      blocks.end());
+  std::sort(blocks.begin(), blocks.end(),
+            [](const SlowBlock &a, const SlowBlock &b) {
+              return a.load > b.load;
+            });
+  return blocks;
+}
+
+std::array<juce::uint64, BlockTimeRecorder::kNumBins>
+BlockTimeRecorder::getHistogram() const {
+  std::array<juce::uint64, kNumBins> counts;
+  for (size_t i = 0; i < counts.size(); ++i)
+    counts[i] = histogram[i].load(std::memory_order_relaxed);
+  return counts;
+}
+
+juce::var
+BlockTimeRecorder::createReport(const juce::StringArray &parameterIds) const {
+  auto *report = new juce::DynamicObject();
+  report->setProperty("blocks", (juce::int64)getNumBlocks());
+  report->setProperty("deadline_misses", (juce::int64)getNumDeadlineMisses());
+
+  // Bin i covers [i, i + 1) * bin_width_percent; the last bin is open ended
+  auto *histogramObject = new juce::DynamicObject();
+  histogramObject->setProperty("bin_width_percent", kBinWidth * 100.0f);
+  juce::Array<juce::var> counts;
+  for (auto count : getHistogram())
+    counts.add((juce::int64)count);
+  histogramObject->setProperty("counts", counts);
+  report->setProperty("histogram", juce::var(histogramObject));
+
+  juce::Array<juce::var> blocks;
+  for (const auto &block : getSlowestBlocks()) {
+    auto *entry = new juce::DynamicObject();
+    entry->setProperty("load_percent", block.load * 100.0f);
+    entry->setProperty("cpu_ms", block.cpuSeconds * 1000.0f);
+    entry->setProperty("budget_ms",
+                       1000.0 * block.numSamples / block.sampleRate);
+    entry->setProperty("block_size", block.numSamples);
+    entry->setProperty("sample_rate", block.sampleRate);
+    entry->setProperty("block_index", block.blockIndex);
+    entry->setProperty("time", juce::Time(block.timeMillis).toISO8601(true));
+    entry->setProperty("quality", block.quality);
+
+    juce::Array<juce::var> modules;
+    for (int bit = 0; bit < NumModules; ++bit)
+      if ((block.modules & (1u << bit)) != 0)
+        modules.add(getModuleName(bit));
+    entry->setProperty("modules", modules);
+
+    entry->setProperty("preset_loaded", (block.events & EventPresetLoad) != 0);
+    entry->setProperty("after_prepare", (block.events & EventPrepare) != 0);
+
+    juce::Array<juce::var> changes;
+    for (int i = 0; i < juce::jmin(block.numParamChanges, kMaxParamChanges);
+         ++i) {
+      const int index = block.paramChanges[(size_t)i];
+      changes.add(juce::isPositiveAndBelow(index, parameterIds.size())
+                      ? juce::var(parameterIds[index])
+                      : juce::var(index));
+    }
+    entry->setProperty("parameter_changes", changes);
+    entry->setProperty("parameter_changes_total", block.numParamChanges);
+
+    blocks.add(juce::var(entry));
+  }
+  report->setProperty("slowest_blocks", blocks);
+
+  return juce::var(report);
+}
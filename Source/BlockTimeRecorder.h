@@ -0,0 +1,107 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Records how long every processBlock took relative to its real-time
+// budget: a histogram over all blocks plus the slowest kNumSlowest blocks
+// with enough context to tie a spike to a patch. Everything is
+// preallocated; the audio thread never locks or allocates, and readers on
+// the message thread copy the table under a sequence counter.
+class BlockTimeRecorder {
+public:
+  // Modules that were doing work in a block
+  enum Module : juce::uint32 {
+    ModuleGate = 1u << 0,
+    ModuleDrive = 1u << 1,
+    ModulePitch = 1u << 2,
+    ModuleEcho = 1u << 3,
+    ModuleReverb = 1u << 4,
+    ModuleWidth = 1u << 5,
+    ModuleInstrument = 1u << 6,
+    ModuleAnalyzer = 1u << 7,
+  };
+  static constexpr int NumModules = 8;
+
+  // Events since the previous block
+  enum Event : juce::uint32 {
+    EventPresetLoad = 1u << 0,
+    EventPrepare = 1u << 1,
+  };
+
+  static constexpr int kNumSlowest = 32;
+  static constexpr int kMaxParamChanges = 8;
+  static constexpr int kNumBins = 64;
+  static constexpr float kBinWidth = 0.025f; // 2.5% of the budget per bin
+
+  struct SlowBlock {
+    float load = 0.0f; // processBlock time / audio duration of the block
+    float cpuSeconds = 0.0f;
+    int numSamples = 0;
+    double sampleRate = 0.0;
+    juce::int64 blockIndex = 0;
+    juce::int64 timeMillis = 0; // Wall clock, for lining up with xrun logs
+    juce::uint32 modules = 0;
+    juce::uint32 events = 0;
+    int quality = 0;
+
+    // Indices into the tracked parameter list; numParamChanges may exceed
+    // kMaxParamChanges, only the first ones are kept
+    int numParamChanges = 0;
+    std::array<juce::int16, kMaxParamChanges> paramChanges{};
+  };
+
+  static const char *getModuleName(int bit);
+
+  // Message thread, before playback. Allocates the per-parameter state.
+  void setParameters(const juce::Array<juce::AudioProcessorParameter *> &);
+
+  // Any thread
+  void notePresetLoad() {
+    pendingEvents.fetch_or(EventPresetLoad, std::memory_order_relaxed);
+  }
+  void notePrepare() {
+    pendingEvents.fetch_or(EventPrepare, std::memory_order_relaxed);
+  }
+
+  // Audio thread, start of the block: picks up parameter changes and events
+  void beginBlock();
+
+  // Audio thread, end of the block
+  void endBlock(float cpuSeconds, int numSamples, double sampleRate,
+                juce::uint32 modules, int quality);
+
+  // Message thread. Slowest blocks first.
+  std::vector<SlowBlock> getSlowestBlocks() const;
+  std::array<juce::uint64, kNumBins> getHistogram() const;
+  juce::uint64 getNumBlocks() const {
+    return numBlocks.load(std::memory_order_relaxed);
+  }
+  juce::uint64 getNumDeadlineMisses() const {
+    return deadlineMisses.load(std::memory_order_relaxed);
+  }
+
+  // JSON summary; parameterIds maps the indices of setParameters()
+  juce::var createReport(const juce::StringArray &parameterIds) const;
+
+private:
+  // Audio thread state
+  std::vector<juce::AudioProcessorParameter *> parameters;
+  std::vector<float> lastValues;
+  SlowBlock current;
+  int fastestSlot = 0;
+
+  std::atomic<juce::uint32> pendingEvents{0};
+
+  std::array<std::atomic<juce::uint64>, kNumBins> histogram{};
+  std::atomic<juce::uint64> numBlocks{0};
+  std::atomic<juce::uint64> deadlineMisses{0};
+
+  // Odd while the audio thread is rewriting a slot
+  std::atomic<juce::uint32> sequence{0};
+  std::array<SlowBlock, kNumSlowest> slowest{};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BlockTimeRecorder)
+};
@@ -6,6 +6,7 @@
 #include <array>
 #include <cmath>
 #include "DSPUtils.h" // For daisysp namespace and utils
+#include "SIMDUtils.h"
 
 namespace infrasonic {
 
@@ -37,6 +38,14 @@ class BiquadSection {
 
         void SetCoefficients(const Coefficients coefficients) { coefs_ = coefficients; }
 
+        /// Clears the filter state, keeping the coefficients
+        void Reset()
+        {
+            for (int i = 0; i < 4; i++) {
+                s1_[i] = s2_[i] = 0.0f;
+            }
+        }
+
         inline float Process(const float in, const int channel)
         {
             assert(channel < 2);
@@ -54,13 +63,55 @@ class BiquadSection {
             return y;
         }
 
+        /// Both channels in one register, left/right in lanes 0/1
+        inline simd::float4 ProcessStereo(const simd::float4 in)
+        {
+            const simd::float4 b0 = simd::set1(coefs_[0]);
+            const simd::float4 b1 = simd::set1(coefs_[1]);
+            const simd::float4 b2 = simd::set1(coefs_[2]);
+            const simd::float4 a1 = simd::set1(coefs_[3]);
+            const simd::float4 a2 = simd::set1(coefs_[4]);
+
+            const simd::float4 s1 = simd::load(s1_);
+            const simd::float4 s2 = simd::load(s2_);
+
+            const simd::float4 y = b0 * in + s1;
+            simd::store(s1_, s2 + in * b1 - a1 * y);
+            simd::store(s2_, b2 * in - a2 * y);
+            return y;
+        }
+
+        /// ProcessStereo() over a block, in place, with the state kept in
+        /// registers for the whole block
+        inline void ProcessStereoBlock(float *left, float *right, const size_t size)
+        {
+            const simd::float4 b0 = simd::set1(coefs_[0]);
+            const simd::float4 b1 = simd::set1(coefs_[1]);
+            const simd::float4 b2 = simd::set1(coefs_[2]);
+            const simd::float4 a1 = simd::set1(coefs_[3]);
+            const simd::float4 a2 = simd::set1(coefs_[4]);
+
+            simd::float4 s1 = simd::load(s1_);
+            simd::float4 s2 = simd::load(s2_);
+            for (size_t i = 0; i < size; i++) {
+                const simd::float4 in = simd::set(left[i], right[i], 0.0f, 0.0f);
+                const simd::float4 y = b0 * in + s1;
+                s1 = s2 + in * b1 - a1 * y;
+                s2 = b2 * in - a2 * y;
+                left[i] = simd::lane(y, 0);
+                right[i] = simd::lane(y, 1);
+            }
+            simd::store(s1_, s1);
+            simd::store(s2_, s2);
+        }
+
     private:
         // coef
         Coefficients coefs_{0, 0, 0, 0, 0};
 
-        // state
-        float s1_[2] = {0, 0};
-        float s2_[2] = {0, 0};
+        // state, one lane per channel (lanes 2/3 unused)
+        alignas(16) float s1_[4] = {0, 0, 0, 0};
+        alignas(16) float s2_[4] = {0, 0, 0, 0};
 
 };
 
@@ -115,11 +166,19 @@ class BiquadCascade {
         {
             const float angleIncrement = 1.f / (4.f * static_cast<float>(NumSections));
             for (size_t i=0; i<NumSections; i++) {
-                q_[i] = 1.f / (2.f * cosf(PI_F * (angleIncrement * (i * 2 + 1))));
+                q_[i] = 1.f / (2.f * fastmath::cos(PI_F * (angleIncrement * (i * 2 + 1))));
             }
             updateCoefficients();
         }
 
+        /// Clears the filter state, keeping the coefficients
+        void Reset()
+        {
+            for (auto &biquad : biquads_) {
+                biquad.Reset();
+            }
+        }
+
         inline float Process(const float in)
         {
             float out = in;
@@ -129,12 +188,23 @@ class BiquadCascade {
             return out;
         }
 
-        /// In-place stereo processing
+        /// In-place stereo processing. Both channels go through every
+        /// section together in one SIMD register.
         inline void ProcessStereo(float &sampL, float &sampR)
+        {
+            simd::float4 samp = simd::set(sampL, sampR, 0.0f, 0.0f);
+            for (auto &biquad : biquads_) {
+                samp = biquad.ProcessStereo(samp);
+            }
+            sampL = simd::lane(samp, 0);
+            sampR = simd::lane(samp, 1);
+        }
+
+        /// ProcessStereo() over a block, in place, one section at a time
+        inline void ProcessStereoBlock(float *left, float *right, const size_t size)
         {
             for (auto &biquad : biquads_) {
-                sampL = biquad.Process(sampL, 0);
-                sampR = biquad.Process(sampR, 1);
+                biquad.ProcessStereoBlock(left, right, size);
             }
         }
 
@@ -158,12 +228,18 @@ using LPF12 = BiquadCascade<1, BiquadSection::FilterType::LowPass>;
 /// 24dB/Oct resonant lowpass filter
 using LPF24 = BiquadCascade<2, BiquadSection::FilterType::LowPass>;
 
+/// 36dB/Oct resonant lowpass filter
+using LPF36 = BiquadCascade<3, BiquadSection::FilterType::LowPass>;
+
 /// 12dB/Oct resonant highpass filter
 using HPF12 = BiquadCascade<1, BiquadSection::FilterType::HighPass>;
 
 /// 24dB/Oct resonant highpass filter
 using HPF24 = BiquadCascade<2, BiquadSection::FilterType::HighPass>;
 
+/// 36dB/Oct resonant highpass filter
+using HPF36 = BiquadCascade<3, BiquadSection::FilterType::HighPass>;
+
 /// 12dB/Oct resonant bandpass filter
 using BPF12 = BiquadCascade<1, BiquadSection::FilterType::BandPass>;
 
@@ -0,0 +1,325 @@
+#pragma once
+#ifndef INFS_DSPMATH_H
+#define INFS_DSPMATH_H
+
+#include "SIMDUtils.h"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace infrasonic {
+
+/**
+ * Fast approximations of the transcendental functions used by the DSP code.
+ *
+ * Every function is a template over float and simd::float4, so the same
+ * polynomial runs per sample or four lanes at a time. Maximum errors against
+ * double precision libm over the stated domain, as checked by dawdrey-bench
+ * (log2 and lin2db: absolute while the result is below 1, relative above):
+ *
+ *   exp2(x)    x in [-126, 127]            relative  2e-7
+ *   exp(x)     x in [-87, 88]              relative  3e-7
+ *   log2(x)    x > 0                       mixed     2e-7
+ *   sin(x)     x in [-pi, pi]              absolute  5e-7
+ *   cos(x)     x in [-pi, pi]              absolute  2e-7
+ *   tan(x)     |x| <= 1.55                 relative  3e-6
+ *   tanh(x)    any x                       absolute  5e-7
+ *   mtof(nn)   nn in [-24, 160]            relative  1e-6
+ *   db2lin(db) db in [-120, 120]           relative  1e-6
+ *   lin2db(x)  x > 0                       mixed     3e-7
+ *
+ * Inputs outside the domain are clamped where that is cheap (exp2 saturates,
+ * log2 of zero, negative or denormal input returns -126). The error of sin
+ * and cos grows with |x| through range reduction, roughly |x| * 7e-8, and
+ * tan loses accuracy towards pi/2.
+ * Results differ from libm in the last bits, so they are not bit-exact
+ * replacements.
+ */
+namespace fastmath {
+
+namespace detail {
+
+    template<typename T> inline T constant(float c);
+    template<> inline float constant<float>(float c) { return c; }
+    template<> inline simd::float4 constant<simd::float4>(float c) { return simd::set1(c); }
+
+    inline float abs(float x)                           { return std::fabs(x); }
+    inline float min(float a, float b)                  { return a < b ? a : b; }
+    inline float max(float a, float b)                  { return a > b ? a : b; }
+    inline bool  less(float a, float b)                 { return a < b; }
+    inline float select(bool mask, float a, float b)    { return mask ? a : b; }
+
+    using simd::abs;
+    using simd::min;
+    using simd::max;
+    using simd::less;
+    using simd::select;
+
+    /// Returns 2^round(x) and sets frac = x - round(x), for x in [-126, 127]
+    inline float pow2_round(float x, float &frac)
+    {
+        // Biased exponent is positive here, so truncation rounds down
+        const int32_t e = static_cast<int32_t>(x + 127.5f);
+        frac = x - static_cast<float>(e - 127);
+        return std::bit_cast<float>(static_cast<uint32_t>(e) << 23);
+    }
+
+    // log2_split() splits normal x > 0 into a mantissa in [sqrt(0.5), sqrt(2))
+    // and returns the exponent. Offsetting the bits by sqrt(0.5) first moves
+    // the exponent boundary there, so no compare is needed.
+    static constexpr int32_t kSqrtHalfBits = 0x3f3504f3;
+
+    inline float log2_split(float x, float &mantissa)
+    {
+        const int32_t bits = std::bit_cast<int32_t>(x);
+        const int32_t e = (bits - kSqrtHalfBits) >> 23;
+        mantissa = std::bit_cast<float>(bits - (e << 23));
+        return static_cast<float>(e);
+    }
+
+    // round(): nearest integer, |x| < 2^31
+
+#if INFS_SIMD_SSE
+
+    inline float round(float x) { return static_cast<float>(_mm_cvtss_si32(_mm_set_ss(x))); }
+
+    inline simd::float4 round(simd::float4 x) { return { _mm_cvtepi32_ps(_mm_cvtps_epi32(x.v)) }; }
+
+    inline simd::float4 pow2_round(simd::float4 x, simd::float4 &frac)
+    {
+        const __m128i n = _mm_cvtps_epi32(x.v);
+        frac = { _mm_sub_ps(x.v, _mm_cvtepi32_ps(n)) };
+        return { _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23)) };
+    }
+
+    inline simd::float4 log2_split(simd::float4 x, simd::float4 &mantissa)
+    {
+        const __m128i bits = _mm_castps_si128(x.v);
+        const __m128i e = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(kSqrtHalfBits)), 23);
+        mantissa = { _mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(e, 23))) };
+        return { _mm_cvtepi32_ps(e) };
+    }
+
+#elif INFS_SIMD_NEON
+
+    inline float round(float x) { return static_cast<float>(vcvtns_s32_f32(x)); }
+
+    inline simd::float4 round(simd::float4 x) { return { vcvtq_f32_s32(vcvtnq_s32_f32(x.v)) }; }
+
+    inline simd::float4 pow2_round(simd::float4 x, simd::float4 &frac)
+    {
+        const int32x4_t n = vcvtnq_s32_f32(x.v);
+        frac = { vsubq_f32(x.v, vcvtq_f32_s32(n)) };
+        return { vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23)) };
+    }
+
+    inline simd::float4 log2_split(simd::float4 x, simd::float4 &mantissa)
+    {
+        const int32x4_t bits = vreinterpretq_s32_f32(x.v);
+        const int32x4_t e = vshrq_n_s32(vsubq_s32(bits, vdupq_n_s32(kSqrtHalfBits)), 23);
+        mantissa = { vreinterpretq_f32_s32(vsubq_s32(bits, vshlq_n_s32(e, 23))) };
+        return { vcvtq_f32_s32(e) };
+    }
+
+#else
+
+    inline float round(float x)
+    {
+        const float y = x + 0.5f;
+        const float t = static_cast<float>(static_cast<int32_t>(y));
+        return t - (y < t ? 1.0f : 0.0f);
+    }
+
+    inline simd::float4 round(simd::float4 x)
+    {
+        for (int i = 0; i < 4; i++) x.v[i] = round(x.v[i]);
+        return x;
+    }
+
+    inline simd::float4 pow2_round(simd::float4 x, simd::float4 &frac)
+    {
+        for (int i = 0; i < 4; i++) x.v[i] = pow2_round(x.v[i], frac.v[i]);
+        return x;
+    }
+
+    inline simd::float4 log2_split(simd::float4 x, simd::float4 &mantissa)
+    {
+        for (int i = 0; i < 4; i++) x.v[i] = log2_split(x.v[i], mantissa.v[i]);
+        return x;
+    }
+
+#endif
+
+    // Polynomials are evaluated in Estrin form: a few more multiplies than
+    // Horner, but a much shorter dependency chain in per-sample code.
+
+    /// 1 + f * P(f) ~ 2^f for |f| <= 0.5 (Cephes exp2f)
+    template<typename T>
+    inline T exp2_poly(const T f)
+    {
+        const T f2 = f * f;
+        const T p01 = constant<T>(6.931472028550421e-1f) + constant<T>(2.402264791363012e-1f) * f;
+        const T p23 = constant<T>(5.550332471162809e-2f) + constant<T>(9.618437357674640e-3f) * f;
+        const T p45 = constant<T>(1.339887440266574e-3f) + constant<T>(1.535336188319500e-4f) * f;
+        return constant<T>(1.0f) + f * (p01 + f2 * (p23 + f2 * p45));
+    }
+
+    /// sin(2 pi v) for |v| <= 0.25 (Taylor series to x^11, error < 6e-8)
+    template<typename T>
+    inline T sin2pi_quarter(const T v)
+    {
+        const T x  = v * constant<T>(6.283185307179586f);
+        const T x2 = x * x;
+        T p = constant<T>(-2.5052108385e-8f);
+        p = p * x2 + constant<T>(2.7557319224e-6f);
+        p = p * x2 + constant<T>(-1.9841269841e-4f);
+        p = p * x2 + constant<T>(8.3333333333e-3f);
+        p = p * x2 + constant<T>(-1.6666666667e-1f);
+        return x + x * x2 * p;
+    }
+
+} // namespace detail
+
+/// 2^x. Cephes polynomial on the fraction, exponent built directly.
+template<typename T>
+inline T exp2(T x)
+{
+    using detail::constant;
+    x = detail::min(detail::max(x, constant<T>(-126.0f)), constant<T>(127.0f));
+
+    T f;
+    const T scale = detail::pow2_round(x, f); // f in [-0.5, 0.5]
+    return detail::exp2_poly(f) * scale;
+}
+
+/// e^x. Like exp2, with the fraction taken from x - n ln(2) in two parts so
+/// large arguments keep their precision.
+template<typename T>
+inline T exp(T x)
+{
+    using detail::constant;
+    const T log2e = constant<T>(1.4426950408889634f);
+    x = detail::min(detail::max(x, constant<T>(-87.3f)), constant<T>(88.0f));
+
+    T f;
+    const T y = x * log2e;
+    const T scale = detail::pow2_round(y, f);
+    const T n = y - f;
+    f = ((x - n * constant<T>(0.693359375f)) - n * constant<T>(-2.12194440e-4f)) * log2e;
+    return detail::exp2_poly(f) * scale;
+}
+
+/// log2(x). Cephes log1p polynomial on the mantissa.
+template<typename T>
+inline T log2(T x)
+{
+    using detail::constant;
+    x = detail::max(x, constant<T>(1.17549435e-38f)); // Smallest normal
+
+    T m;
+    const T e = detail::log2_split(x, m);
+    const T z  = m - constant<T>(1.0f);
+    const T z2 = z * z;
+    const T z4 = z2 * z2;
+    const T p01 = constant<T>(3.3333331174e-1f) + constant<T>(-2.4999993993e-1f) * z;
+    const T p23 = constant<T>(2.0000714765e-1f) + constant<T>(-1.6668057665e-1f) * z;
+    const T p45 = constant<T>(1.4249322787e-1f) + constant<T>(-1.2420140846e-1f) * z;
+    const T p67 = constant<T>(1.1676998740e-1f) + constant<T>(-1.1514610310e-1f) * z;
+    const T p = (p01 + z2 * p23) + z4 * ((p45 + z2 * p67) + z4 * constant<T>(7.0376836292e-2f));
+    const T ln = z + z * z2 * p - constant<T>(0.5f) * z2; // ln(m)
+    return ln * constant<T>(1.4426950408889634f) + e;
+}
+
+template<typename T>
+inline T cos(const T x)
+{
+    using detail::constant;
+    T t = x * constant<T>(0.15915494309189535f); // Turns
+    t = t - detail::round(t);
+    // cos(2 pi t) = sin(2 pi (1/4 - |t|))
+    return detail::sin2pi_quarter(constant<T>(0.25f) - detail::abs(t));
+}
+
+template<typename T>
+inline T sin(const T x)
+{
+    using detail::constant;
+    // sin(2 pi t) = cos(2 pi (t - 1/4))
+    T t = x * constant<T>(0.15915494309189535f) - constant<T>(0.25f);
+    t = t - detail::round(t);
+    return detail::sin2pi_quarter(constant<T>(0.25f) - detail::abs(t));
+}
+
+/// tan(x) for |x| < pi/2 (e.g. bilinear prewarping). Cephes polynomial up to
+/// pi/4, cotangent of the complement above.
+template<typename T>
+inline T tan(const T x)
+{
+    using detail::constant;
+    const T ax = detail::abs(x);
+    const auto upper = detail::less(constant<T>(0.7853981633974483f), ax);
+    const T y = detail::select(upper, constant<T>(1.5707963267948966f) - ax, ax);
+
+    const T z = y * y;
+    T p = constant<T>(9.38540185543e-3f);
+    p = p * z + constant<T>(3.11992232697e-3f);
+    p = p * z + constant<T>(2.44301354525e-2f);
+    p = p * z + constant<T>(5.34112807005e-2f);
+    p = p * z + constant<T>(1.33387994085e-1f);
+    p = p * z + constant<T>(3.33331568548e-1f);
+    const T t = y + y * z * p;
+
+    const T r = detail::select(upper, constant<T>(1.0f) / t, t);
+    return detail::select(detail::less(x, constant<T>(0.0f)), constant<T>(0.0f) - r, r);
+}
+
+/// tanh(x). 13/6 rational fit, saturating to +-1 beyond |x| = 7.9.
+template<typename T>
+inline T tanh(T x)
+{
+    using detail::constant;
+    const T limit = constant<T>(7.90531110763549805f);
+    x = detail::min(detail::max(x, constant<T>(0.0f) - limit), limit);
+
+    const T x2 = x * x;
+    T p = constant<T>(-2.76076847742355e-16f);
+    p = p * x2 + constant<T>(2.00018790482477e-13f);
+    p = p * x2 + constant<T>(-8.60467152213735e-11f);
+    p = p * x2 + constant<T>(5.12229709037114e-08f);
+    p = p * x2 + constant<T>(1.48572235717979e-05f);
+    p = p * x2 + constant<T>(6.37261928875436e-04f);
+    p = p * x2 + constant<T>(4.89352455891786e-03f);
+
+    T q = constant<T>(1.19825839466702e-06f);
+    q = q * x2 + constant<T>(1.18534705686654e-04f);
+    q = q * x2 + constant<T>(2.26843463243900e-03f);
+    q = q * x2 + constant<T>(4.89352518554385e-03f);
+    return x * p / q;
+}
+
+/// MIDI note number to Hz (A4 = 69 = 440 Hz)
+template<typename T>
+inline T mtof(const T nn)
+{
+    using detail::constant;
+    return exp2((nn - constant<T>(69.0f)) * constant<T>(1.0f / 12.0f)) * constant<T>(440.0f);
+}
+
+/// Decibels to linear gain
+template<typename T>
+inline T db2lin(const T db)
+{
+    return exp2(db * detail::constant<T>(0.16609640474436813f)); // log2(10) / 20
+}
+
+/// Linear gain to decibels
+template<typename T>
+inline T lin2db(const T lin)
+{
+    return log2(lin) * detail::constant<T>(6.020599913279624f); // 20 log10(2)
+}
+
+} // namespace fastmath
+} // namespace infrasonic
+
+#endif
@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include "DSPMath.h"
 
 // Minimal DaisySP replacements
 namespace daisysp {
@@ -12,8 +13,8 @@ namespace daisysp {
     inline float fclamp(float in, float min, float max) {
         return (in < min) ? min : (in > max) ? max : in;
     }
-    inline float pow10f(float x) { return powf(10.0f, x); }
-    inline float fastlog10f(float x) { return log10f(x); }
+    inline float pow10f(float x) { return infrasonic::fastmath::exp2(x * 3.321928095f); }
+    inline float fastlog10f(float x) { return infrasonic::fastmath::log2(x) * 0.301029996f; }
     
     static constexpr float PI_F = 3.1415927410125732421875f;
     static constexpr float TWOPI_F = 2.0f * PI_F;
@@ -25,11 +26,11 @@ static constexpr float PI_F = daisysp::PI_F;
 static constexpr float TWOPI_F = daisysp::TWOPI_F;
 
 inline float dbfs2lin(float dbfs) {
-    return daisysp::pow10f(dbfs * 0.05f);
+    return fastmath::db2lin(dbfs);
 }
 
 inline float lin2dbfs(float lin) {
-    return daisysp::fastlog10f(lin) * 20.0f;
+    return fastmath::lin2db(lin);
 }
 
 // Coefficient for one pole smoothing filter based on Tau time constant for `time_s`
@@ -52,7 +53,7 @@ inline float ftension(const float in, const float factor)
 
 inline float tanf(const float x)
 {
-    return std::tan(x);
+    return fastmath::tan(x);
 }
 
 }
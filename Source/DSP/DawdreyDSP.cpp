@@ -0,0 +1,198 @@
+#include "DawdreyDSP.h"
+#include "FeedbackSynthEngine.h"
+
+#include <cmath>
+#include <cstring>
+#include <new>
+
+using infrasonic::FeedbackSynth::Engine;
+
+namespace {
+
+struct ParamSpec {
+  float min, max, def;
+};
+
+// Same order as dawdrey_param
+constexpr ParamSpec kParamSpecs[DAWDREY_PARAM_COUNT] = {
+    {0.0f, 127.0f, 40.0f},       // STRING_PITCH
+    {-60.0f, 12.0f, -6.0f},      // FEEDBACK_GAIN
+    {0.001f, 0.25f, 0.064f},     // FEEDBACK_DELAY
+    {20.0f, 20000.0f, 18000.0f}, // FEEDBACK_LPF
+    {20.0f, 20000.0f, 60.0f},    // FEEDBACK_HPF
+    {0.0f, 1.0f, 0.0f},          // REVERB_MIX
+    {0.0f, 1.0f, 0.85f},         // REVERB_DECAY
+    {0.0f, 1.0f, 0.0f},          // ECHO_SEND
+    {0.01f, 5.0f, 0.5f},         // ECHO_TIME
+    {0.0f, 1.2f, 0.5f},          // ECHO_FEEDBACK
+    {0.0f, 1.0f, 1.0f},          // OUTPUT_LEVEL
+    {0.0f, 1.0f, 1.0f},          // QUALITY
+    {0.0f, 1.0f, 0.0f},          // PITCH_ENABLED
+    {-12.0f, 12.0f, 0.0f},       // PITCH_SHIFT
+    {-100.0f, 100.0f, 0.0f},     // PITCH_FINE
+    {0.0f, 1.0f, 0.0f},          // INSTRUMENT_MODE
+    {0.0f, 127.0f, 69.0f},       // MIDI_NOTE
+    {0.0f, 2.0f, 0.0f},          // FEEDBACK_SLOPE
+    {1.0f, 4.0f, 1.0f},          // ECHO_TAPS
+    {0.0f, 1.0f, 0.0f},          // ECHO_PING_PONG
+    {0.0f, 2.0f, 0.0f},          // ECHO_STORAGE
+};
+
+bool IsValid(const dawdrey_param param) {
+  return param >= 0 && param < DAWDREY_PARAM_COUNT;
+}
+
+} // namespace
+
+struct dawdrey_engine {
+  Engine engine;
+  float params[DAWDREY_PARAM_COUNT];
+  bool prepared = false;
+
+  // The engine's setters depend on the sample rate, so values only reach it
+  // once prepared; before that they are just stored.
+  void Apply(const dawdrey_param param) {
+    if (!prepared)
+      return;
+
+    const float v = params[param];
+    switch (param) {
+    case DAWDREY_PARAM_STRING_PITCH:
+      engine.SetStringPitch(v);
+      break;
+    case DAWDREY_PARAM_FEEDBACK_GAIN:
+      engine.SetFeedbackGain(v);
+      break;
+    case DAWDREY_PARAM_FEEDBACK_DELAY:
+      engine.SetFeedbackDelay(v);
+      break;
+    case DAWDREY_PARAM_FEEDBACK_LPF:
+      engine.SetFeedbackLPFCutoff(v);
+      break;
+    case DAWDREY_PARAM_FEEDBACK_HPF:
+      engine.SetFeedbackHPFCutoff(v);
+      break;
+    case DAWDREY_PARAM_REVERB_MIX:
+      engine.SetReverbMix(v);
+      break;
+    case DAWDREY_PARAM_REVERB_DECAY:
+      engine.SetReverbFeedback(v);
+      break;
+    case DAWDREY_PARAM_ECHO_SEND:
+      engine.SetEchoDelaySendAmount(v);
+      break;
+    case DAWDREY_PARAM_ECHO_TIME:
+      engine.SetEchoDelayTime(v);
+      break;
+    case DAWDREY_PARAM_ECHO_FEEDBACK:
+      engine.SetEchoDelayFeedback(v);
+      break;
+    case DAWDREY_PARAM_OUTPUT_LEVEL:
+      engine.SetOutputLevel(v);
+      break;
+    case DAWDREY_PARAM_QUALITY:
+      engine.SetQuality(static_cast<Engine::Quality>(std::lround(v)));
+      break;
+    case DAWDREY_PARAM_PITCH_ENABLED:
+      engine.pitchEnabled = v >= 0.5f;
+      break;
+    case DAWDREY_PARAM_PITCH_SHIFT:
+      engine.pitchShift = v;
+      break;
+    case DAWDREY_PARAM_PITCH_FINE:
+      engine.pitchFine = v;
+      break;
+    case DAWDREY_PARAM_INSTRUMENT_MODE:
+      engine.instrumentMode = v >= 0.5f;
+      break;
+    case DAWDREY_PARAM_MIDI_NOTE:
+      engine.SetMidiPitch(v);
+      break;
+    case DAWDREY_PARAM_FEEDBACK_SLOPE:
+      engine.SetFeedbackFilterSlope(
+          static_cast<infrasonic::LowHighFilter::Slope>(std::lround(v)));
+      break;
+    case DAWDREY_PARAM_ECHO_TAPS:
+      engine.SetEchoDelayTaps((size_t)std::lround(v));
+      break;
+    case DAWDREY_PARAM_ECHO_PING_PONG:
+      engine.SetEchoDelayPingPong(v >= 0.5f);
+      break;
+    case DAWDREY_PARAM_ECHO_STORAGE:
+      // Allocation setting, already passed on by dawdrey_prepare
+      break;
+    case DAWDREY_PARAM_COUNT:
+      break;
+    }
+  }
+};
+
+extern "C" {
+
+int dawdrey_api_version(void) { return DAWDREY_DSP_API_VERSION; }
+
+dawdrey_engine *dawdrey_create(void) {
+  auto *e = new (std::nothrow) dawdrey_engine();
+  if (e == nullptr)
+    return nullptr;
+
+  for (int i = 0; i < DAWDREY_PARAM_COUNT; i++)
+    e->params[i] = kParamSpecs[i].def;
+  return e;
+}
+
+dawdrey_result dawdrey_prepare(dawdrey_engine *e, double sample_rate) {
+  if (e == nullptr || !(sample_rate > 0.0))
+    return DAWDREY_ERROR_INVALID_ARGUMENT;
+
+  e->prepared = false;
+  e->engine.SetEchoDelayStorage(static_cast<infrasonic::SampleFormat>(
+      std::lround(e->params[DAWDREY_PARAM_ECHO_STORAGE])));
+  try {
+    e->engine.Init(static_cast<float>(sample_rate));
+  } catch (const std::bad_alloc &) {
+    return DAWDREY_ERROR_OUT_OF_MEMORY;
+  }
+
+  e->prepared = true;
+  for (int i = 0; i < DAWDREY_PARAM_COUNT; i++)
+    e->Apply(static_cast<dawdrey_param>(i));
+  return DAWDREY_OK;
+}
+
+dawdrey_result dawdrey_set_param(dawdrey_engine *e, dawdrey_param param,
+                                 float value) {
+  if (e == nullptr || !IsValid(param) || std::isnan(value))
+    return DAWDREY_ERROR_INVALID_ARGUMENT;
+
+  const auto &spec = kParamSpecs[param];
+  e->params[param] = std::fmin(std::fmax(value, spec.min), spec.max);
+  e->Apply(param);
+  return DAWDREY_OK;
+}
+
+float dawdrey_get_param(const dawdrey_engine *e, dawdrey_param param) {
+  if (e == nullptr || !IsValid(param))
+    return 0.0f;
+  return e->params[param];
+}
+
+void dawdrey_process(dawdrey_engine *e, const float *input,
+                     float *output_left, float *output_right,
+                     int num_frames) {
+  if (output_left == nullptr || output_right == nullptr || num_frames <= 0)
+    return;
+
+  if (e == nullptr || !e->prepared || input == nullptr) {
+    std::memset(output_left, 0, sizeof(float) * num_frames);
+    std::memset(output_right, 0, sizeof(float) * num_frames);
+    return;
+  }
+
+  e->engine.ProcessBlock(input, output_left, output_right,
+                         static_cast<size_t>(num_frames));
+}
+
+void dawdrey_destroy(dawdrey_engine *e) { delete e; }
+
+} // extern "C"
@@ -0,0 +1,90 @@
+#pragma once
+#ifndef DAWDREY_DSP_H
+#define DAWDREY_DSP_H
+
+// C interface to the feedback resonator (infrasonic::FeedbackSynth::Engine),
+// for hosts that embed the DSP core without JUCE. Link against the
+// dawdrey_dsp static library.
+//
+//   dawdrey_engine *e = dawdrey_create();
+//   dawdrey_prepare(e, 48000.0);
+//   dawdrey_set_param(e, DAWDREY_PARAM_FEEDBACK_GAIN, -3.0f);
+//   dawdrey_process(e, in, out_l, out_r, 256);   // audio thread
+//   dawdrey_destroy(e);
+//
+// dawdrey_create, dawdrey_prepare and dawdrey_destroy allocate or free and
+// must not be called on a real-time thread. dawdrey_set_param and
+// dawdrey_process never allocate or lock. A single engine is not
+// thread-safe: the host serialises calls on one instance.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DAWDREY_DSP_API_VERSION 4
+
+typedef struct dawdrey_engine dawdrey_engine;
+
+/// Parameters in the plugin's units; defaults match the plugin's init patch
+typedef enum dawdrey_param {
+  DAWDREY_PARAM_STRING_PITCH = 0,  ///< MIDI note number, 0-127 (40)
+  DAWDREY_PARAM_FEEDBACK_GAIN,     ///< dB, -60 to 12 (-6)
+  DAWDREY_PARAM_FEEDBACK_DELAY,    ///< seconds, 0.001 to 0.25 (0.064)
+  DAWDREY_PARAM_FEEDBACK_LPF,      ///< Hz, 20 to 20000 (18000)
+  DAWDREY_PARAM_FEEDBACK_HPF,      ///< Hz, 20 to 20000 (60)
+  DAWDREY_PARAM_REVERB_MIX,        ///< 0-1 (0)
+  DAWDREY_PARAM_REVERB_DECAY,      ///< 0-1 (0.85)
+  DAWDREY_PARAM_ECHO_SEND,         ///< 0-1 (0)
+  DAWDREY_PARAM_ECHO_TIME,         ///< seconds, 0.01 to 5 (0.5)
+  DAWDREY_PARAM_ECHO_FEEDBACK,     ///< 0-1.2 (0.5)
+  DAWDREY_PARAM_OUTPUT_LEVEL,      ///< linear gain, 0-1 (1)
+  DAWDREY_PARAM_QUALITY,           ///< 0 = eco, 1 = normal (1)
+  DAWDREY_PARAM_PITCH_ENABLED,     ///< 0 or 1 (0)
+  DAWDREY_PARAM_PITCH_SHIFT,       ///< semitones, -12 to 12 (0)
+  DAWDREY_PARAM_PITCH_FINE,        ///< cents, -100 to 100 (0)
+  DAWDREY_PARAM_INSTRUMENT_MODE,   ///< 0 or 1: tune to MIDI_NOTE instead (0)
+  DAWDREY_PARAM_MIDI_NOTE,         ///< MIDI note in instrument mode, 0-127 (69)
+  DAWDREY_PARAM_FEEDBACK_SLOPE,    ///< 0 = 12, 1 = 24, 2 = 36 dB/oct (0)
+  DAWDREY_PARAM_ECHO_TAPS,         ///< playback heads, 1-4 (1)
+  DAWDREY_PARAM_ECHO_PING_PONG,    ///< 0 or 1 (0)
+  DAWDREY_PARAM_ECHO_STORAGE,      ///< 0 = float, 1 = int16, 2 = half (0);
+                                   ///< applies at the next dawdrey_prepare
+  DAWDREY_PARAM_COUNT
+} dawdrey_param;
+
+typedef enum dawdrey_result {
+  DAWDREY_OK = 0,
+  DAWDREY_ERROR_INVALID_ARGUMENT = -1,
+  DAWDREY_ERROR_OUT_OF_MEMORY = -2
+} dawdrey_result;
+
+/// Returns DAWDREY_DSP_API_VERSION of the library actually linked
+int dawdrey_api_version(void);
+
+/// New engine with default parameters, or NULL if out of memory
+dawdrey_engine *dawdrey_create(void);
+
+/// Allocates buffers for the sample rate and clears all state. Parameters
+/// set earlier are kept. May be called again to change the rate.
+dawdrey_result dawdrey_prepare(dawdrey_engine *engine, double sample_rate);
+
+/// Values are clamped to the documented range; NaN is rejected
+dawdrey_result dawdrey_set_param(dawdrey_engine *engine, dawdrey_param param,
+                                 float value);
+
+/// Current value of a parameter, 0 for unknown parameters
+float dawdrey_get_param(const dawdrey_engine *engine, dawdrey_param param);
+
+/// Processes num_frames of mono input into a stereo output. Output may
+/// alias input. Writes silence until the engine has been prepared.
+void dawdrey_process(dawdrey_engine *engine, const float *input,
+                     float *output_left, float *output_right, int num_frames);
+
+/// Accepts NULL
+void dawdrey_destroy(dawdrey_engine *engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
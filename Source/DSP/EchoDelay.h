@@ -5,31 +5,51 @@
 #include "daisysp/DelayLine.h"
 #include "BiquadFilters.h"
 #include "DSPUtils.h"
+#include "SIMDUtils.h"
+#include "SampleStorage.h"
+#include <algorithm>
 
 namespace infrasonic {
 
 /**
  * @brief
- * Tape-ish echo delay.
+ * Stereo tape-ish echo delay.
  *   - Feedback is unbounded, but signal is soft-clipped
  *   - Output is full-wet, should be mixed with dry signal externally
+ *   - Up to kMaxTaps playback heads, summed like a multi-head tape echo.
+ *     Every head reads the same line per channel, so extra heads cost no
+ *     memory.
+ *   - Optional ping-pong: repeats cross to the other channel on each pass
  *
  * @tparam MaxLength Max length of delay in samples
+ * @tparam Format Sample format of the lines. The band-pass and clipping
+ *                keep the repeats well above the 16-bit formats' noise.
  */
-template<size_t MaxLength>
+template<size_t MaxLength, SampleFormat Format = SampleFormat::Float32>
 class EchoDelay {
 
     public:
 
+        static constexpr size_t kMaxTaps = 4;
+
+        /// ProcessBlock() works in chunks of up to kMaxChunk samples, and
+        /// falls back to per-sample processing below kMinChunk
+        static constexpr size_t kMinChunk = 4;
+        static constexpr size_t kMaxChunk = 64;
+
         EchoDelay() {}
         ~EchoDelay() {}
 
         void Init(float sample_rate)
         {
             sample_rate_ = sample_rate;
-            delayLine_.Init();
+            for (auto &line : lines_) {
+                line.Init();
+            }
             bpf_.Init(sample_rate);
             bpf_.SetParams(800.0f, 1.0f);
+            SetNumTaps(1);
+            SetTap(0, 1.0f, 1.0f);
         }
 
         /**
@@ -66,23 +86,124 @@ class EchoDelay {
             feedback_ = feedback;
         }
 
-        inline float Process(const float in)
+        /// Number of playback heads in use, 1 to kMaxTaps
+        void SetNumTaps(const size_t num_taps)
+        {
+            num_taps_ = std::clamp(num_taps, size_t(1), kMaxTaps);
+        }
+
+        /**
+         * @brief Place one playback head
+         *
+         * @param index 0 to kMaxTaps - 1
+         * @param time_ratio Head position as a fraction of the delay time, 0-1
+         * @param gain Linear level of the head in the output and feedback
+         */
+        void SetTap(const size_t index, const float time_ratio, const float gain)
+        {
+            if (index >= kMaxTaps) return;
+            tap_ratio_[index] = daisysp::fclamp(time_ratio, 0.0f, 1.0f);
+            tap_gain_[index] = gain;
+        }
+
+        /// If true, each channel's repeats feed back into the other channel
+        void SetPingPong(const bool ping_pong)
+        {
+            ping_pong_ = ping_pong;
+        }
+
+        inline void Process(const float inL, const float inR, float &outL, float &outR)
         {
-            float out;
             // Simple one-pole smoothing
             delay_time_current_ += delay_smooth_coef_ * (delay_time_target_ - delay_time_current_);
-            
-            delayLine_.SetDelay(delay_time_current_ * sample_rate_);
-            out = delayLine_.Read();
-            out = bpf_.Process(out);
-            
+            const float delay = clampDelay(delay_time_current_ * sample_rate_);
+
+            float out[2] = {0.0f, 0.0f};
+            for (size_t t = 0; t < num_taps_; t++) {
+                const float tap_delay = clampDelay(delay * tap_ratio_[t]);
+                out[0] += tap_gain_[t] * lines_[0].Read(tap_delay);
+                out[1] += tap_gain_[t] * lines_[1].Read(tap_delay);
+            }
+            bpf_.ProcessStereo(out[0], out[1]);
+
             // Soft clip
             // Using simple tanh approximation or similar
-            if (out > 1.0f) out = 1.0f;
-            else if (out < -1.0f) out = -1.0f;
-            
-            delayLine_.Write(out * feedback_ + in);
-            return out;
+            out[0] = daisysp::fclamp(out[0], -1.0f, 1.0f);
+            out[1] = daisysp::fclamp(out[1], -1.0f, 1.0f);
+
+            const size_t fb = ping_pong_ ? 1 : 0;
+            lines_[0].Write(out[fb] * feedback_ + inL);
+            lines_[1].Write(out[1 - fb] * feedback_ + inR);
+            outL = out[0];
+            outR = out[1];
+        }
+
+        /**
+         * @brief Block form of Process(). Inputs may alias the outputs.
+         *
+         * The delay time glide is rendered into a buffer a chunk at a time.
+         * While the shortest head is longer than a chunk, every head is
+         * read for the whole chunk with SIMD before any of it is written
+         * back, and the clip and feedback mix run four samples at a time.
+         */
+        void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t size)
+        {
+            alignas(16) float delay[kMaxChunk];
+            alignas(16) float tap_delay[kMaxChunk];
+            alignas(16) float read[kMaxChunk];
+            alignas(16) float out[2][kMaxChunk];
+
+            float min_ratio = 1.0f;
+            for (size_t t = 0; t < num_taps_; t++) {
+                min_ratio = daisysp::fmin(min_ratio, tap_ratio_[t]);
+            }
+
+            size_t done = 0;
+            while (done < size) {
+                // The glide is monotonic, so no head in the chunk reads
+                // closer than this, and a chunk of min_delay - 1 samples
+                // only reads samples written before it
+                const float min_delay = clampDelay(min_ratio * clampDelay(sample_rate_
+                                                   * daisysp::fmin(delay_time_current_, delay_time_target_)));
+                const size_t n = std::min({kMaxChunk, size - done, static_cast<size_t>(min_delay) - 1});
+                if (n < kMinChunk) {
+                    Process(inL[done], inR[done], outL[done], outR[done]);
+                    done++;
+                    continue;
+                }
+
+                for (size_t i = 0; i < n; i++) {
+                    delay_time_current_ += delay_smooth_coef_ * (delay_time_target_ - delay_time_current_);
+                    delay[i] = clampDelay(delay_time_current_ * sample_rate_);
+                }
+
+                std::fill(out[0], out[0] + n, 0.0f);
+                std::fill(out[1], out[1] + n, 0.0f);
+                for (size_t t = 0; t < num_taps_; t++) {
+                    for (size_t i = 0; i < n; i++) {
+                        tap_delay[i] = clampDelay(delay[i] * tap_ratio_[t]);
+                    }
+                    for (size_t c = 0; c < 2; c++) {
+                        lines_[c].ReadBlock(tap_delay, read, n);
+                        accumulate(out[c], read, tap_gain_[t], n);
+                    }
+                }
+
+                // Recursive, so per sample, with both channels in one register
+                bpf_.ProcessStereoBlock(out[0], out[1], n);
+
+                const size_t fb = ping_pong_ ? 1 : 0;
+                clipAndMix(out[fb], inL + done, read, n);
+                lines_[0].WriteBlock(read, n);
+                clipAndMix(out[1 - fb], inR + done, read, n);
+                lines_[1].WriteBlock(read, n);
+
+                // out[] is clipped in place, and the writes are done with
+                // the inputs, so the outputs can overwrite them now
+                std::copy(out[0], out[0] + n, outL + done);
+                std::copy(out[1], out[1] + n, outR + done);
+                done += n;
+            }
         }
 
     private:
@@ -92,6 +213,9 @@ class EchoDelay {
         EchoDelay& operator=(const EchoDelay &other) = delete;
         EchoDelay& operator=(EchoDelay &&other) = delete;
 
+        // Keeps the interpolation neighbour inside the line
+        static constexpr float kMaxDelay = static_cast<float>(MaxLength - 2);
+
         float sample_rate_;
         float delay_time_current_;
         float delay_time_target_;
@@ -99,8 +223,49 @@ class EchoDelay {
 
         float feedback_;
 
-        daisysp::DelayLine<float, MaxLength> delayLine_;
+        size_t num_taps_ = 1;
+        float tap_ratio_[kMaxTaps] = {1.0f, 1.0f, 1.0f, 1.0f};
+        float tap_gain_[kMaxTaps] = {1.0f, 0.0f, 0.0f, 0.0f};
+        bool ping_pong_ = false;
+
+        daisysp::DelayLine<float, MaxLength, Format> lines_[2];
         BPF12 bpf_;
+
+        static inline float clampDelay(const float delay_samp)
+        {
+            return daisysp::fclamp(delay_samp, 1.0f, kMaxDelay);
+        }
+
+        /// out += gain * in
+        static inline void accumulate(float *out, const float *in, const float gain, const size_t size)
+        {
+            const simd::float4 g = simd::set1(gain);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                simd::store(out + i, simd::load(out + i) + g * simd::load(in + i));
+            }
+            for (; i < size; i++) {
+                out[i] += gain * in[i];
+            }
+        }
+
+        /// Clips echo in place and writes echo * feedback + in to write
+        inline void clipAndMix(float *echo, const float *in, float *write, const size_t size) const
+        {
+            const simd::float4 lo = simd::set1(-1.0f);
+            const simd::float4 hi = simd::set1(1.0f);
+            const simd::float4 fb = simd::set1(feedback_);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                const simd::float4 e = simd::clamp(simd::load(echo + i), lo, hi);
+                simd::store(echo + i, e);
+                simd::store(write + i, e * fb + simd::load(in + i));
+            }
+            for (; i < size; i++) {
+                echo[i] = daisysp::fclamp(echo[i], -1.0f, 1.0f);
+                write[i] = echo[i] * feedback_ + in[i];
+            }
+        }
 };
 
 }
@@ -1,25 +1,48 @@
 #include "FeedbackSynthEngine.h"
 #include "DSPUtils.h"
+#include <algorithm>
 
 using namespace infrasonic;
 using namespace infrasonic::FeedbackSynth;
 using namespace daisysp;
 
-static float mtof(float m) { return 440.0f * powf(2.0f, (m - 69.0f) / 12.0f); }
-
 static void fonepole(float &out, float in, float coeff) {
   out += coeff * (in - out);
 }
 
 void Engine::Init(const float sample_rate) {
-  using ED = EchoDelay<kMaxEchoDelaySamp>;
-
-  // Use standard allocation instead of SDRAM
-  echo_delay_[0] = std::make_unique<ED>();
-  echo_delay_[1] = std::make_unique<ED>();
-  verb_ = std::make_unique<ReverbSc>();
+  // Use standard allocation instead of SDRAM. The buffers do not depend on
+  // the sample rate, so re-prepares reuse them; delay lines only clear what
+  // was written since they were last reset.
+  if (verb_ == nullptr)
+    verb_ = std::make_unique<ReverbSc>();
+  // Release the old echo before allocating one in another format
+  if (echo_storage_ != SampleFormat::Float32)
+    echo_delay_.reset();
+  if (echo_storage_ != SampleFormat::Int16)
+    echo_delay_i16_.reset();
+  if (echo_storage_ != SampleFormat::Float16)
+    echo_delay_f16_.reset();
+  switch (echo_storage_) {
+  case SampleFormat::Float32:
+    if (echo_delay_ == nullptr)
+      echo_delay_ = std::make_unique<EchoDelay<kMaxEchoDelaySamp>>();
+    break;
+  case SampleFormat::Int16:
+    if (echo_delay_i16_ == nullptr)
+      echo_delay_i16_ = std::make_unique<
+          EchoDelay<kMaxEchoDelaySamp, SampleFormat::Int16>>();
+    break;
+  case SampleFormat::Float16:
+    if (echo_delay_f16_ == nullptr)
+      echo_delay_f16_ = std::make_unique<
+          EchoDelay<kMaxEchoDelaySamp, SampleFormat::Float16>>();
+    break;
+  }
 
   sample_rate_ = sample_rate;
+  loop_energy_ = 0.0f;
+  loop_tap_ = 0.0f;
   fb_delay_smooth_coef_ = onepole_coef(0.2f, sample_rate);
 
   noise_.Init();
@@ -34,28 +57,40 @@ void Engine::Init(const float sample_rate) {
 
     fb_delayline_[i].Init();
 
-    echo_delay_[i]->Init(sample_rate);
-    echo_delay_[i]->SetDelayTime(0.5f, true); // Default 500ms
-    echo_delay_[i]->SetFeedback(0.5f);
-    echo_delay_[i]->SetLagTime(0.5f);
-
     overdrive_[i].Init();
     overdrive_[i].SetDrive(0.4f);
 
     pitchShifter[i].Init(sample_rate);
   }
 
+  withEcho([&](auto &echo) {
+    echo.Init(sample_rate);
+    echo.SetDelayTime(echo_time_, true); // Default 500ms
+    echo.SetFeedback(0.5f);
+    echo.SetLagTime(0.5f);
+    echo.SetPingPong(echo_ping_pong_);
+  });
+  SetEchoDelayTaps(echo_taps_);
+
+  overdrive_adaa_.Init();
+  overdrive_adaa_.SetDrive(0.4f);
+
   verb_->Init(sample_rate);
   verb_->SetFeedback(0.85f);
   verb_->SetLpFreq(18000.0f);
 
-  fb_lpf_.Init(sample_rate);
-  fb_lpf_.SetQ(0.9f);
-  fb_lpf_.SetCutoff(18000.0f);
-
-  fb_hpf_.Init(sample_rate);
-  fb_hpf_.SetQ(0.9f);
-  fb_hpf_.SetCutoff(60.f);
+  // Block-rate cutoff updates glide per sample
+  fb_filter_.Init(sample_rate);
+  fb_filter_.SetQ(0.9f);
+  fb_filter_.SetLagTime(0.002f);
+  fb_filter_.SetLowPassCutoff(18000.0f, true);
+  fb_filter_.SetHighPassCutoff(60.f, true);
+
+  // Hold times cover each stage's longest internal delay, so a stage only
+  // sleeps once nothing above threshold is left circulating in it
+  echo_activity_.Init(sample_rate, kMaxEchoDelaySamp / sample_rate);
+  verb_activity_.Init(sample_rate, 0.25f);
+  pitch_activity_.Init(sample_rate, 0.2f);
 }
 
 void Engine::SetStringPitch(const float nn) { freq_param_ = nn; }
@@ -70,21 +105,42 @@ void Engine::SetFeedbackDelay(const float delay_s) {
 }
 
 void Engine::SetFeedbackLPFCutoff(const float cutoff_hz) {
-  fb_lpf_.SetCutoff(cutoff_hz);
+  fb_filter_.SetLowPassCutoff(cutoff_hz);
 }
 
 void Engine::SetFeedbackHPFCutoff(const float cutoff_hz) {
-  fb_hpf_.SetCutoff(cutoff_hz);
+  fb_filter_.SetHighPassCutoff(cutoff_hz);
+}
+
+void Engine::SetFeedbackFilterSlope(const LowHighFilter::Slope slope) {
+  fb_filter_.SetSlope(slope);
 }
 
 void Engine::SetEchoDelayTime(const float echo_time) {
-  echo_delay_[0]->SetDelayTime(echo_time);
-  echo_delay_[1]->SetDelayTime(echo_time);
+  echo_time_ = echo_time;
+  withEcho([&](auto &echo) { echo.SetDelayTime(echo_time); });
 }
 
 void Engine::SetEchoDelayFeedback(const float echo_fb) {
-  echo_delay_[0]->SetFeedback(echo_fb);
-  echo_delay_[1]->SetFeedback(echo_fb);
+  withEcho([&](auto &echo) { echo.SetFeedback(echo_fb); });
+}
+
+void Engine::SetEchoDelayTaps(const size_t num_taps) {
+  using ED = EchoDelay<kMaxEchoDelaySamp>;
+  echo_taps_ = std::clamp(num_taps, size_t(1), ED::kMaxTaps);
+  // Evenly spaced heads, the last at the full delay time. The gains sum to
+  // one, so the feedback amount means the same for any number of heads.
+  withEcho([&](auto &echo) {
+    echo.SetNumTaps(echo_taps_);
+    for (size_t t = 0; t < echo_taps_; t++)
+      echo.SetTap(t, (float)(t + 1) / (float)echo_taps_,
+                  1.0f / (float)echo_taps_);
+  });
+}
+
+void Engine::SetEchoDelayPingPong(const bool ping_pong) {
+  echo_ping_pong_ = ping_pong;
+  withEcho([&](auto &echo) { echo.SetPingPong(ping_pong); });
 }
 
 void Engine::SetEchoDelaySendAmount(const float echo_send) {
@@ -99,6 +155,22 @@ void Engine::SetReverbFeedback(const float time) { verb_->SetFeedback(time); }
 
 void Engine::SetOutputLevel(const float level) { output_level_ = level; }
 
+float Engine::TakeLoopEnergy() {
+  const float energy = loop_energy_;
+  loop_energy_ = 0.0f;
+  return energy;
+}
+
+void Engine::SetQuality(const Quality quality) {
+  if (quality == quality_)
+    return;
+
+  quality_ = quality;
+  drive_latency_ =
+      (quality_ == Quality::Eco) ? 0.0f : OverdriveADAA::kGroupDelay;
+  overdrive_adaa_.Reset();
+}
+
 void Engine::Process(float in, float &outL, float &outR) {
   // --- Update audio-rate-smoothed control params ---
 
@@ -109,7 +181,7 @@ void Engine::Process(float in, float &outL, float &outR) {
 
   // --- Process Samples ---
 
-  float inL, inR, sampL, sampR, echoL, echoR, verbL, verbR;
+  float inL, inR, sampL, sampR;
   const float noise_samp = noise_.Process();
 
   // ---> Feedback Loop
@@ -117,36 +189,137 @@ void Engine::Process(float in, float &outL, float &outR) {
   // Get noise + feedback output
   // Read from delay line
   // Note: DaisySP DelayLine Read takes float delay
-  inL = fb_delayline_[0].Read(fb_delay_samp_) + noise_samp + in;
-  inR = fb_delayline_[1].Read(daisysp::fmax(1.0f, fb_delay_samp_ - 4.f)) +
+  // The loop clipper's group delay and the filters' latency are taken off the
+  // read position so the body delay stays in tune regardless of quality tier
+  const float fb_delay =
+      fb_delay_samp_ - drive_latency_ - LowHighFilter::kLatency;
+  inL = fb_delayline_[0].Read(daisysp::fmax(1.0f, fb_delay)) + noise_samp + in;
+  inR = fb_delayline_[1].Read(daisysp::fmax(1.0f, fb_delay - 4.f)) +
         noise_samp + in;
 
   // Process through KS resonator
-  sampL = strings_[0].Process(inL);
-  sampR = strings_[1].Process(inR);
+  {
+    INFS_PROFILE_SCOPE(profiler_, StageProfiler::EngineStrings);
+    sampL = strings_[0].Process(inL);
+    sampR = strings_[1].Process(inR);
+  }
+
+  float fbL, fbR;
+  processAfterStrings(sampL, sampR, fbL, fbR, outL, outR);
+  fb_delayline_[0].Write(fbL);
+  fb_delayline_[1].Write(fbR);
+
+  processEcho(&outL, &outR, 1);
+}
+
+void Engine::ProcessBlock(const float *in, float *outL, float *outR,
+                          size_t size, float *loopTap) {
+  alignas(16) float delayL[kMaxLoopChunk], delayR[kMaxLoopChunk];
+  alignas(16) float sampL[kMaxLoopChunk], sampR[kMaxLoopChunk];
+  alignas(16) float fbL[kMaxLoopChunk], fbR[kMaxLoopChunk];
+  alignas(16) float wetL[kMaxLoopChunk], wetR[kMaxLoopChunk];
+
+  size_t done = 0;
+  while (done < size) {
+    // The read delay only glides between its current and target values, so
+    // a chunk no longer than the shorter of those (right channel) reads
+    // nothing that the chunk itself writes back
+    const float min_delay =
+        daisysp::fmin(fb_delay_samp_, fb_delay_samp_target_) -
+        drive_latency_ - LowHighFilter::kLatency - 4.f;
+    const size_t chunk =
+        std::min({kMaxLoopChunk, size - done,
+                  static_cast<size_t>(daisysp::fmax(0.0f, min_delay))});
+    if (chunk < kMinLoopChunk) {
+      float dropR;
+      Process(in[done], outL[done], outR != nullptr ? outR[done] : dropR);
+      if (loopTap != nullptr)
+        loopTap[done] = loop_tap_;
+      done++;
+      continue;
+    }
+
+    for (size_t i = 0; i < chunk; i++) {
+      fb_delay_samp_ +=
+          fb_delay_smooth_coef_ * (fb_delay_samp_target_ - fb_delay_samp_);
+      const float fb_delay =
+          fb_delay_samp_ - drive_latency_ - LowHighFilter::kLatency;
+      delayL[i] = daisysp::fmax(1.0f, fb_delay);
+      delayR[i] = daisysp::fmax(1.0f, fb_delay - 4.f);
+    }
+    fb_delayline_[0].ReadBlock(delayL, sampL, chunk);
+    fb_delayline_[1].ReadBlock(delayR, sampR, chunk);
+    for (size_t i = 0; i < chunk; i++) {
+      const float noise_samp = noise_.Process();
+      sampL[i] = sampL[i] + noise_samp + in[done + i];
+      sampR[i] = sampR[i] + noise_samp + in[done + i];
+    }
+
+    {
+      INFS_PROFILE_SCOPE(profiler_, StageProfiler::EngineStrings);
+      strings_[0].ProcessBlock(sampL, sampL, chunk);
+      strings_[1].ProcessBlock(sampR, sampR, chunk);
+    }
+
+    for (size_t i = 0; i < chunk; i++) {
+      processAfterStrings(sampL[i], sampR[i], fbL[i], fbR[i], wetL[i],
+                          wetR[i]);
+      if (loopTap != nullptr)
+        loopTap[done + i] = loop_tap_;
+    }
+    fb_delayline_[0].WriteBlock(fbL, chunk);
+    fb_delayline_[1].WriteBlock(fbR, chunk);
+
+    processEcho(wetL, wetR, chunk);
+    std::copy(wetL, wetL + chunk, outL + done);
+    if (outR != nullptr)
+      std::copy(wetR, wetR + chunk, outR + done);
+    done += chunk;
+  }
+}
+
+void Engine::processAfterStrings(float sampL, float sampR, float &fbL,
+                                 float &fbR, float &outL, float &outR) {
+  float verbL = 0.0f, verbR = 0.0f;
 
   // Distort + Clip
-  sampL = overdrive_[0].Process(sampL);
-  sampR = overdrive_[1].Process(sampR);
+  {
+    INFS_PROFILE_SCOPE(profiler_, StageProfiler::EngineDrive);
+    if (quality_ == Quality::Eco) {
+      sampL = overdrive_[0].Process(sampL);
+      sampR = overdrive_[1].Process(sampR);
+    } else {
+      overdrive_adaa_.ProcessStereo(sampL, sampR);
+    }
+  }
 
   // Filter in feedback loop
-  fb_lpf_.ProcessStereo(sampL, sampR);
-  fb_hpf_.ProcessStereo(sampL, sampR);
+  {
+    INFS_PROFILE_SCOPE(profiler_, StageProfiler::EngineFilters);
+    fb_filter_.ProcessStereo(sampL, sampR);
+  }
 
   // ---> Reverb
 
-  verb_->Process(sampL, sampR, &verbL, &verbR);
-
-  //       (sampL * (1.0f - verb_mix_)) + verbL * verb_mix_;
-  //       sampL - sampL * verb_mix + verbL * verb_mix_;
-  sampL -= (sampL - verbL) * verb_mix_;
-  sampR -= (sampR - verbR) * verb_mix_;
+  // At zero mix the reverb is inaudible, so its tail runs on silence
+  if (verb_activity_.Begin(verb_mix_ > 0.0f)) {
+    INFS_PROFILE_SCOPE(profiler_, StageProfiler::EngineReverb);
+    if (verb_activity_.IsActive()) {
+      verb_->Process(sampL, sampR, &verbL, &verbR);
+
+      //       (sampL * (1.0f - verb_mix_)) + verbL * verb_mix_;
+      //       sampL - sampL * verb_mix + verbL * verb_mix_;
+      sampL -= (sampL - verbL) * verb_mix_;
+      sampR -= (sampR - verbR) * verb_mix_;
+    } else {
+      verb_->Process(0.0f, 0.0f, &verbL, &verbR);
+      verb_activity_.End(verbL, verbR);
+    }
+  }
 
   // Calculate Target Frequency
-  float target_freq = mtof(freq_param_);
-  if (instrumentMode) {
-    target_freq = mtof(midi_pitch_);
-  }
+  const float target_freq =
+      fastmath::mtof(instrumentMode ? midi_pitch_ : freq_param_);
 
   // Smooth Frequency
   fonepole(freq_, target_freq, 0.01f); // Smooth transition
@@ -155,33 +328,72 @@ void Engine::Process(float in, float &outL, float &outR) {
 
   // ---> Resonator feedback
 
-  float fbL = sampL;
-  float fbR = sampR;
-
-  // Pitch Shifter (Applied only to feedback signal)
-  if (pitchEnabled) {
-    float shift = pitchShift + (pitchFine / 100.0f);
+  fbL = sampL;
+  fbR = sampR;
+
+  // Pitch Shifter (Applied only to feedback signal). Once disabled it is
+  // flushed with silence, so re-enabling it does not replay stale audio.
+  if (pitch_activity_.Begin(pitchEnabled)) {
+    INFS_PROFILE_SCOPE(profiler_, StageProfiler::EnginePitch);
+    if (pitch_activity_.IsActive()) {
+      float shift = pitchShift + (pitchFine / 100.0f);
+
+      pitchShifter[0].SetShift(shift);
+      fbL = pitchShifter[0].Process(fbL);
+
+      pitchShifter[1].SetShift(shift);
+      fbR = pitchShifter[1].Process(fbR);
+    } else {
+      pitch_activity_.End(pitchShifter[0].Process(0.0f),
+                          pitchShifter[1].Process(0.0f));
+    }
+  }
 
-    pitchShifter[0].SetShift(shift);
-    fbL = pitchShifter[0].Process(fbL);
+  // Written back into the delay by the caller, with attenuation
+  fbL *= fb_gain_;
+  fbR *= fb_gain_;
+  loop_energy_ += fbL * fbL + fbR * fbR;
+  loop_tap_ = 0.5f * (fbL + fbR);
 
-    pitchShifter[1].SetShift(shift);
-    fbR = pitchShifter[1].Process(fbR);
-  }
+  outL = sampL;
+  outR = sampR;
+}
 
-  // Write back into delay with attenuation
-  fb_delayline_[0].Write(fbL * fb_gain_);
-  fb_delayline_[1].Write(fbR * fb_gain_);
+void Engine::processEcho(float *sampL, float *sampR, size_t size) {
+  alignas(16) float echoL[kMaxLoopChunk], echoR[kMaxLoopChunk];
+  if (size == 0)
+    return;
 
   // ---> Echo Delay
 
-  echoL = echo_delay_[0]->Process(sampL * echo_send_);
-  echoR = echo_delay_[1]->Process(sampR * echo_send_);
-
-  sampL = 0.5f * (sampL + echoL);
-  sampR = 0.5f * (sampR + echoR);
+  // Delay time changes while asleep are not glided through on waking
+  const bool echo_was_sleeping = echo_activity_.IsSleeping();
+  if (echo_activity_.Begin(echo_send_ > 0.0f)) {
+    INFS_PROFILE_SCOPE(profiler_, StageProfiler::EngineEcho);
+    for (size_t i = 0; i < size; i++) {
+      echoL[i] = sampL[i] * echo_send_;
+      echoR[i] = sampR[i] * echo_send_;
+    }
+    const bool rendered = withEcho([&](auto &echo) {
+      if (echo_was_sleeping)
+        echo.SetDelayTime(echo_time_, true);
+      echo.ProcessBlock(echoL, echoR, echoL, echoR, size);
+    });
+    // Without an echo the buffers still hold the send, not echo output
+    if (!rendered) {
+      std::fill(echoL, echoL + size, 0.0f);
+      std::fill(echoR, echoR + size, 0.0f);
+    }
+    for (size_t i = 0; i < size; i++)
+      echo_activity_.End(echoL[i], echoR[i]);
+  } else {
+    std::fill(echoL, echoL + size, 0.0f);
+    std::fill(echoR, echoR + size, 0.0f);
+  }
 
   // ---> Output
-  outL = sampL * output_level_;
-  outR = sampR * output_level_;
+  for (size_t i = 0; i < size; i++) {
+    sampL[i] = 0.5f * (sampL[i] + echoL[i]) * output_level_;
+    sampR[i] = 0.5f * (sampR[i] + echoR[i]) * output_level_;
+  }
 }
@@ -6,7 +6,12 @@
 #include "DSPUtils.h"
 #include "EchoDelay.h"
 #include "KarplusString.h"
+#include "LowHighFilter.h"
+#include "OverdriveADAA.h"
 #include "PitchShifter.h"
+#include "SampleStorage.h"
+#include "StageActivity.h"
+#include "StageProfiler.h"
 #include "daisysp/DelayLine.h"
 #include "daisysp/Overdrive.h"
 #include "daisysp/ReverbSc.h"
@@ -19,6 +24,11 @@ namespace FeedbackSynth {
 class Engine {
 
 public:
+  /// Processing quality tiers, trading CPU for fidelity.
+  ///  - Eco: original branching clipper in the feedback loop
+  ///  - Normal: anti-aliased (ADAA) clipper in the feedback loop
+  enum class Quality { Eco, Normal };
+
   Engine() = default;
   ~Engine() = default;
 
@@ -31,10 +41,19 @@ public:
   void SetFeedbackDelay(const float delay_s);
   void SetFeedbackLPFCutoff(const float cutoff_hz);
   void SetFeedbackHPFCutoff(const float cutoff_hz);
+  void SetFeedbackFilterSlope(const LowHighFilter::Slope slope);
 
   void SetEchoDelayTime(const float echo_time);
   void SetEchoDelayFeedback(const float echo_fb);
   void SetEchoDelaySendAmount(const float echo_send);
+  /// 1-4 evenly spaced playback heads, the last at the echo time
+  void SetEchoDelayTaps(const size_t num_taps);
+  /// Repeats alternate between the channels
+  void SetEchoDelayPingPong(const bool ping_pong);
+  /// Sample format of the echo lines (Float32 by default). The 16-bit
+  /// formats halve the echo's memory. Takes effect at the next Init(),
+  /// which reallocates the echo if the format changed.
+  void SetEchoDelayStorage(const SampleFormat format) { echo_storage_ = format; }
 
   // Both range 0-1
   void SetReverbMix(const float mix);
@@ -42,8 +61,38 @@ public:
 
   void SetOutputLevel(const float level);
 
+  void SetQuality(const Quality quality);
+
   void Process(float in, float &outL, float &outR);
 
+  /// Block form of Process(); in may alias either output. outR may be null
+  /// to drop the right channel, and loopTap, if given, receives
+  /// GetLoopTap() for every sample. While the loop delay is at least
+  /// kMinLoopChunk samples, the loop delay lines are read and the strings
+  /// run a chunk at a time (see KarplusString::ProcessBlock). The echo
+  /// always runs a chunk at a time.
+  void ProcessBlock(const float *in, float *outL, float *outR, size_t size,
+                    float *loopTap = nullptr);
+
+  static constexpr size_t kMinLoopChunk = 8;
+  static constexpr size_t kMaxLoopChunk = 64;
+
+  /// Sum of squares of everything written back into the feedback loop
+  /// (both channels) since the previous call. Resets the accumulator.
+  float TakeLoopEnergy();
+
+  /// Mono mix of the last sample written into the feedback delay lines
+  float GetLoopTap() const { return loop_tap_; }
+
+  /// Stage timings go here when built with INFS_PROFILING (may be null)
+  void SetProfiler(StageProfiler *profiler) { profiler_ = profiler; }
+
+  /// Bypass state of the optional stages. Each runs only while it is
+  /// needed or still has a tail, and wakes as soon as it is needed again.
+  const StageActivity &GetEchoActivity() const { return echo_activity_; }
+  const StageActivity &GetReverbActivity() const { return verb_activity_; }
+  const StageActivity &GetPitchActivity() const { return pitch_activity_; }
+
   // Pitch Shifter parameters
   bool pitchEnabled = false;
   float pitchShift = 0.0f; // Semitones
@@ -63,8 +112,20 @@ private:
   float sample_rate_;
   float fb_gain_ = 0.0f;
   float echo_send_ = 0.0f;
+  float echo_time_ = 0.5f;
+  size_t echo_taps_ = 1;
+  bool echo_ping_pong_ = false;
+  SampleFormat echo_storage_ = SampleFormat::Float32;
   float verb_mix_ = 0.0f;
   float output_level_ = 0.5f;
+  float loop_energy_ = 0.0f;
+  float loop_tap_ = 0.0f;
+
+  StageProfiler *profiler_ = nullptr;
+
+  Quality quality_ = Quality::Normal;
+  // Group delay added by the loop clipper, compensated in the loop read
+  float drive_latency_ = OverdriveADAA::kGroupDelay;
 
   float freq_param_ = 440.0f;
   float freq_ = 440.0f;
@@ -77,16 +138,50 @@ private:
   daisysp::WhiteNoise noise_;
   daisysp::DelayLine<float, kMaxFeedbackDelaySamp> fb_delayline_[2];
   daisysp::Overdrive overdrive_[2];
+  OverdriveADAA overdrive_adaa_;
   PitchShifter pitchShifter[2]; // Stereo Pitch Shifter
 
-  LPF12 fb_lpf_;
-  HPF12 fb_hpf_;
+  // Lowpass and highpass in one pass, built from state variable sections
+  // so cutoff sweeps stay smooth and stable
+  LowHighFilter fb_filter_;
 
   using VerbPtr = std::unique_ptr<daisysp::ReverbSc>;
   VerbPtr verb_;
 
-  using EchoDelayPtr = std::unique_ptr<EchoDelay<kMaxEchoDelaySamp>>;
-  EchoDelayPtr echo_delay_[2];
+  // Stereo, one line per channel shared by all playback heads. Only the
+  // one in the format chosen at Init() is allocated.
+  template <SampleFormat Format>
+  using EchoDelayPtr = std::unique_ptr<EchoDelay<kMaxEchoDelaySamp, Format>>;
+  EchoDelayPtr<SampleFormat::Float32> echo_delay_;
+  EchoDelayPtr<SampleFormat::Int16> echo_delay_i16_;
+  EchoDelayPtr<SampleFormat::Float16> echo_delay_f16_;
+
+  /// Calls fn with whichever echo is allocated. Returns false, without
+  /// calling fn, if there is none yet (before Init()).
+  template <typename Fn> bool withEcho(Fn &&fn) {
+    if (echo_delay_)
+      fn(*echo_delay_);
+    else if (echo_delay_i16_)
+      fn(*echo_delay_i16_);
+    else if (echo_delay_f16_)
+      fn(*echo_delay_f16_);
+    else
+      return false;
+    return true;
+  }
+
+  StageActivity echo_activity_;
+  StageActivity verb_activity_;
+  StageActivity pitch_activity_;
+
+  /// Drive to pitch shifter for one sample, after the strings. fbL / fbR
+  /// are what the caller writes back into the loop delay lines, outL / outR
+  /// the signal going on to processEcho().
+  void processAfterStrings(float sampL, float sampR, float &fbL, float &fbR,
+                           float &outL, float &outR);
+
+  /// Echo and output level, in place, for up to kMaxLoopChunk samples
+  void processEcho(float *sampL, float *sampR, size_t size);
 
   Engine(const Engine &other) = delete;
   Engine(Engine &&other) = delete;
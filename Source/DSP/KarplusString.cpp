@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include "KarplusString.h"
 #include <stdlib.h>
@@ -32,6 +33,7 @@ void KarplusString::Reset()
 
     out_sample_[0] = out_sample_[1] = 0.0f;
     src_phase_                      = 0.0f;
+    delay_                          = 0.0f; // Nothing to glide from
 }
 
 float KarplusString::Process(const float in)
@@ -39,6 +41,73 @@ float KarplusString::Process(const float in)
     return ProcessInternal(in);
 }
 
+void KarplusString::ProcessBlock(const float *in, float *out, size_t size)
+{
+    const float target
+        = daisysp::fclamp(1.0f / frequency_, 4.f, kDelayLineSize - 4.0f);
+    const float start = delay_ > 0.0f ? delay_ : target;
+    const float min_delay = fmin(start, target);
+
+    // Too short to chunk, or low enough to need the upsampler
+    if(size == 0 || min_delay < kMinChunk + 1.0f
+       || target * frequency_ < 0.9999f)
+    {
+        for(size_t i = 0; i < size; i++)
+        {
+            out[i] = ProcessInternal(in[i]);
+        }
+        return;
+    }
+
+    // The glide is monotonic, so no read in the block is shorter than
+    // min_delay and a chunk of min_delay - 1 samples only reads samples
+    // written before it
+    const size_t chunk = std::min(kMaxChunk, static_cast<size_t>(min_delay) - 1);
+    const float  step  = (target - start) / static_cast<float>(size);
+
+    const infrasonic::simd::float4 lo = infrasonic::simd::set1(-20.f);
+    const infrasonic::simd::float4 hi = infrasonic::simd::set1(20.f);
+
+    alignas(16) float delay[kMaxChunk];
+    alignas(16) float s[kMaxChunk];
+    for(size_t done = 0; done < size; done += chunk)
+    {
+        const size_t n = std::min(chunk, size - done);
+        for(size_t i = 0; i < n; i++)
+        {
+            delay[i] = start + step * static_cast<float>(done + i + 1);
+        }
+        string_.ReadHermiteBlock(delay, s, n);
+
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            const auto x = infrasonic::simd::load(s + i)
+                           + infrasonic::simd::load(in + done + i);
+            infrasonic::simd::store(s + i, infrasonic::simd::clamp(x, lo, hi));
+        }
+        for(; i < n; i++)
+        {
+            s[i] = daisysp::fclamp(s[i] + in[done + i], -20.f, +20.f);
+        }
+
+        // The filters are recursive, so they stay per sample
+        for(i = 0; i < n; i++)
+        {
+            float v = dc_blocker_.Process(s[i]);
+            v *= 0.8f;
+            v = iir_damping_filter_.Process(v);
+            s[i] = out[done + i] = v;
+        }
+        string_.WriteBlock(s, n);
+    }
+
+    out_sample_[1] = size > 1 ? out[size - 2] : out_sample_[0];
+    out_sample_[0] = out[size - 1];
+    src_phase_     = 1.0f;
+    delay_         = target;
+}
+
 void KarplusString::SetFreq(float freq)
 {
     freq /= sample_rate_;
@@ -61,6 +130,7 @@ float KarplusString::ProcessInternal(const float in)
 
     float delay = 1.0f / frequency_;
     delay       = daisysp::fclamp(delay, 4.f, kDelayLineSize - 4.0f);
+    delay_      = delay;
 
     // If there is not enough delay time in the delay line, we play at the
     // lowest possible note and we upsample on the fly with a shitty linear
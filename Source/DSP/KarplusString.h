@@ -39,6 +39,14 @@ class KarplusString
     */
     float Process(const float in);
 
+    /** Block form of Process(). in and out may alias.
+        While the delay is at least kMinChunk + 1 samples, the delay line is
+        read a chunk at a time with SIMD before any of the chunk is written
+        back, and the delay glides to the current frequency over the block.
+        Shorter delays fall back to per-sample processing.
+    */
+    void ProcessBlock(const float *in, float *out, size_t size);
+
     /** Set the string frequency.
         \param freq Frequency in Hz
     */
@@ -55,6 +63,9 @@ class KarplusString
     void SetDamping(float damping);
 
 
+    static constexpr size_t kMinChunk = 4;
+    static constexpr size_t kMaxChunk = 64;
+
   private:
     static constexpr size_t kDelayLineSize = 8192;
 
@@ -66,6 +77,10 @@ class KarplusString
 
     float sample_rate_;
 
+    // Delay used for the most recent sample, where block glides start from
+    // (0 after a reset)
+    float delay_;
+
     daisysp::Tone iir_damping_filter_;
     daisysp::DcBlock dc_blocker_;
     daisysp::CrossFade crossfade_;
@@ -0,0 +1,251 @@
+#pragma once
+#ifndef INFS_LOWHIGHFILTER_H
+#define INFS_LOWHIGHFILTER_H
+
+#include "DSPMath.h"
+#include "DSPUtils.h"
+#include "SIMDUtils.h"
+#include <cstddef>
+
+namespace infrasonic {
+
+/**
+ * @brief
+ * Stereo lowpass into highpass chain with selectable slope, fused into a
+ * single SIMD pass.
+ *
+ *   - Each filter is a cascade of TPT state variable sections (see
+ *     SVFilter), so cutoff sweeps stay smooth at every slope
+ *   - Lanes hold { LP left, LP right, HP left, HP right }: the highpass
+ *     half works on the lowpass output from the previous sample, so one
+ *     register update per section covers both filters and both channels.
+ *     That costs one sample of latency (kLatency).
+ *   - 12dB/Oct runs one section per filter, at about the price of a
+ *     separate stereo lowpass and highpass SVFilter; 24 and 36dB/Oct add a
+ *     section each
+ *   - Section Qs are Butterworth, with the resonance applied to the
+ *     sharpest section
+ */
+class LowHighFilter {
+
+    public:
+
+        /// Rolloff of both filters
+        enum class Slope {
+            Slope12,
+            Slope24,
+            Slope36
+        };
+
+        static constexpr size_t kMaxSections = 3;
+
+        /// Samples the output lags the input by
+        static constexpr float kLatency = 1.0f;
+
+        LowHighFilter() {}
+        ~LowHighFilter() {}
+
+        void Init(const float sample_rate)
+        {
+            sample_rate_ = sample_rate;
+            SetLagTime(0.0f);
+            SetLowPassCutoff(sample_rate * 0.49f, true);
+            SetHighPassCutoff(1.0f, true);
+            SetSlope(Slope::Slope12);
+            SetQ(0.70710678f);
+            Reset();
+        }
+
+        /**
+         * @brief Set the approximate lag time (smoothing) for cutoff changes, in seconds
+         */
+        void SetLagTime(const float time_s)
+        {
+            g_smooth_coef_ = onepole_coef(time_s, sample_rate_);
+        }
+
+        /**
+         * @param cutoff_hz Clamped to 1 Hz .. 0.49 * sample rate
+         * @param immediately If true, skips the glide
+         */
+        inline void SetLowPassCutoff(const float cutoff_hz, bool immediately = false)
+        {
+            g_target_[0] = prewarp(cutoff_hz);
+            if (immediately) {
+                g_[0] = g_target_[0];
+                updateCoefficients();
+            }
+        }
+
+        /// @see SetLowPassCutoff()
+        inline void SetHighPassCutoff(const float cutoff_hz, bool immediately = false)
+        {
+            g_target_[1] = prewarp(cutoff_hz);
+            if (immediately) {
+                g_[1] = g_target_[1];
+                updateCoefficients();
+            }
+        }
+
+        /// Resonance of the sharpest section of both filters
+        inline void SetQ(const float q)
+        {
+            q_ = daisysp::fmax(q, 0.1f);
+            updateDamping();
+        }
+
+        /// Sections switched in start from silence
+        inline void SetSlope(const Slope slope)
+        {
+            const size_t num_sections = static_cast<size_t>(slope) + 1;
+            if (num_sections > kMaxSections || num_sections == num_sections_) {
+                return;
+            }
+            for (size_t s = num_sections_; s < num_sections; s++) {
+                for (int i = 0; i < 4; i++) {
+                    ic1_[s][i] = ic2_[s][i] = 0.0f;
+                }
+            }
+            num_sections_ = num_sections;
+            updateDamping();
+        }
+
+        Slope GetSlope() const { return static_cast<Slope>(num_sections_ - 1); }
+
+        /// Clears the filter state and completes any cutoff glide
+        void Reset()
+        {
+            for (size_t s = 0; s < kMaxSections; s++) {
+                for (int i = 0; i < 4; i++) {
+                    ic1_[s][i] = ic2_[s][i] = 0.0f;
+                }
+            }
+            for (int i = 0; i < 4; i++) {
+                lp_[i] = 0.0f;
+            }
+            g_[0] = g_target_[0];
+            g_[1] = g_target_[1];
+            updateCoefficients();
+        }
+
+        /// In-place stereo processing, delayed by kLatency
+        inline void ProcessStereo(float &sampL, float &sampR)
+        {
+            tick();
+            simd::float4 x = simd::combine_low(simd::set(sampL, sampR, 0.0f, 0.0f), simd::load(lp_));
+            for (size_t s = 0; s < num_sections_; s++) {
+                const simd::float4 ic1 = simd::load(ic1_[s]);
+                const simd::float4 ic2 = simd::load(ic2_[s]);
+
+                // Same update as SVFilter, with the coefficients folded so
+                // the integrators and the output don't wait on each other
+                const simd::float4 v3 = x - ic2;
+                simd::store(ic1_[s], simd::load(c1_[s]) * ic1 + simd::load(c2_[s]) * v3);
+                simd::store(ic2_[s], ic2 + (simd::load(c2_[s]) * ic1 + simd::load(c3_[s]) * v3));
+
+                // Lowpass or highpass, depending on the lane
+                x = simd::load(mx_[s]) * x + (simd::load(m1_[s]) * ic1 + simd::load(m2_[s]) * ic2);
+            }
+            simd::store(lp_, x);
+
+            sampL = simd::lane(x, 2);
+            sampR = simd::lane(x, 3);
+        }
+
+    private:
+
+        LowHighFilter(const LowHighFilter &other) = delete;
+        LowHighFilter(LowHighFilter &&other) = delete;
+        LowHighFilter& operator=(const LowHighFilter &other) = delete;
+        LowHighFilter& operator=(LowHighFilter &&other) = delete;
+
+        float sample_rate_ = 48000.0f;
+        size_t num_sections_ = 1;
+        float q_ = 0.70710678f;
+
+        // g = tan(pi * fc / fs) for the lowpass / highpass, k = 1 / Q per section
+        float g_[2] = {0.0f, 0.0f};
+        float g_target_[2] = {0.0f, 0.0f};
+        float g_smooth_coef_ = 1.0f;
+        float k_[kMaxSections] = {1.0f, 1.0f, 1.0f};
+
+        // Per section, per lane: integrator updates
+        //   ic1 += c1 * ic1 + c2 * v3 - ic1, ic2 += c2 * ic1 + c3 * v3
+        // with v3 = in - ic2, and output mx * in + m1 * ic1 + m2 * ic2
+        alignas(16) float c1_[kMaxSections][4] = {};
+        alignas(16) float c2_[kMaxSections][4] = {};
+        alignas(16) float c3_[kMaxSections][4] = {};
+        alignas(16) float mx_[kMaxSections][4] = {};
+        alignas(16) float m1_[kMaxSections][4] = {};
+        alignas(16) float m2_[kMaxSections][4] = {};
+        alignas(16) float ic1_[kMaxSections][4] = {};
+        alignas(16) float ic2_[kMaxSections][4] = {};
+
+        // Lowpass output (lanes 0/1), the highpass input for the next sample
+        alignas(16) float lp_[4] = {0, 0, 0, 0};
+
+        inline float prewarp(const float cutoff_hz) const
+        {
+            const float hz = daisysp::fclamp(cutoff_hz, 1.f, sample_rate_ * 0.49f);
+            return fastmath::tan(PI_F * hz / sample_rate_);
+        }
+
+        inline void updateDamping()
+        {
+            // Butterworth pole Qs, same as BiquadCascade::SetFlatResponse()
+            const float angle_increment = 1.f / (4.f * static_cast<float>(num_sections_));
+            const float resonance = q_ / 0.70710678f;
+            for (size_t s = 0; s < num_sections_; s++) {
+                float q = 1.f / (2.f * fastmath::cos(PI_F * (angle_increment * (s * 2 + 1))));
+                if (s == num_sections_ - 1) {
+                    q *= resonance;
+                }
+                k_[s] = 1.0f / q;
+            }
+            updateCoefficients();
+        }
+
+        inline void updateCoefficients()
+        {
+            for (size_t s = 0; s < num_sections_; s++) {
+                for (int f = 0; f < 2; f++) {
+                    const float k = k_[s];
+                    const float a1 = 1.0f / (1.0f + g_[f] * (g_[f] + k));
+                    const float a2 = g_[f] * a1;
+                    const float a3 = g_[f] * a2;
+                    for (int i = 2 * f; i < 2 * f + 2; i++) {
+                        c1_[s][i] = 2.0f * a1 - 1.0f;
+                        c2_[s][i] = 2.0f * a2;
+                        c3_[s][i] = 2.0f * a3;
+                        if (f == 0) {
+                            mx_[s][i] = a3;
+                            m1_[s][i] = a2;
+                            m2_[s][i] = 1.0f - a3;
+                        } else {
+                            mx_[s][i] = 1.0f - k * a2 - a3;
+                            m1_[s][i] = -(k * a1 + a2);
+                            m2_[s][i] = k * a2 + a3 - 1.0f;
+                        }
+                    }
+                }
+            }
+        }
+
+        /// Per-sample glide towards the target cutoffs, landing on them exactly
+        inline void tick()
+        {
+            if (g_[0] != g_target_[0] || g_[1] != g_target_[1]) {
+                for (int f = 0; f < 2; f++) {
+                    const float delta = g_target_[f] - g_[f];
+                    g_[f] = (delta * delta > 1e-12f * g_target_[f] * g_target_[f])
+                                ? g_[f] + g_smooth_coef_ * delta
+                                : g_target_[f];
+                }
+                updateCoefficients();
+            }
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,192 @@
+#pragma once
+#ifndef INFS_OVERDRIVEADAA_H
+#define INFS_OVERDRIVEADAA_H
+
+#include <cmath>
+#include <stddef.h>
+#include "DSPUtils.h"
+#include "SIMDUtils.h"
+
+namespace infrasonic {
+
+/**
+ * @brief
+ * Anti-aliased version of daisysp::Overdrive.
+ *
+ * Same drive mapping and the same transfer curve (hard clip outside +/-1,
+ * x * (1.5 - 0.5x^2) inside) but evaluated with first order antiderivative
+ * anti-aliasing (ADAA) and without data dependent branches:
+ *
+ *   y[n] = (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1])
+ *
+ * F is split into |x| plus a bounded residual so that the difference stays
+ * well conditioned for hot drive settings. When consecutive inputs are
+ * (almost) equal the curve is evaluated at the midpoint instead.
+ *
+ * ADAA adds half a sample of group delay, see kGroupDelay.
+ */
+class OverdriveADAA {
+
+    public:
+
+        /// Group delay introduced by the first order ADAA, in samples
+        static constexpr float kGroupDelay = 0.5f;
+
+        OverdriveADAA() {}
+        ~OverdriveADAA() {}
+
+        void Init()
+        {
+            drive_ = 0.0f;
+            pre_gain_ = 1.0f;
+            post_gain_ = 1.0f;
+            Reset();
+        }
+
+        void Reset()
+        {
+            for (int ch = 0; ch < 2; ch++) {
+                x1_[ch] = 0.0f;
+                h1_[ch] = 0.0f;
+            }
+        }
+
+        /// Set the amount of drive, 0-1. Mapping matches daisysp::Overdrive.
+        void SetDrive(const float drive)
+        {
+            drive_ = drive;
+            pre_gain_ = 1.0f + drive * drive * 48.0f;
+            post_gain_ = 1.0f / std::sqrt(pre_gain_);
+        }
+
+        /// Mono processing, uses the left channel state
+        inline float Process(const float in)
+        {
+            return processScalar(in, 0);
+        }
+
+        /// In-place stereo processing of one sample pair, both channels in one vector
+        inline void ProcessStereo(float &sampL, float &sampR)
+        {
+            using namespace simd;
+            const float4 x  = set(sampL, sampR, 0.0f, 0.0f) * set1(pre_gain_);
+            const float4 xp = set(x1_[0], x1_[1], 0.0f, 0.0f);
+            const float4 hp = set(h1_[0], h1_[1], 0.0f, 0.0f);
+            const float4 h  = residual(x);
+            const float4 y  = kernel(x, h, xp, hp) * set1(post_gain_);
+
+            x1_[0] = lane(x, 0);
+            x1_[1] = lane(x, 1);
+            h1_[0] = lane(h, 0);
+            h1_[1] = lane(h, 1);
+            sampL = lane(y, 0);
+            sampR = lane(y, 1);
+        }
+
+        /// In-place block processing, four samples per vector
+        void ProcessBlock(float *buf, const size_t size, const int channel = 0)
+        {
+            using namespace simd;
+            const float4 pre  = set1(pre_gain_);
+            const float4 post = set1(post_gain_);
+
+            // shift_in() pulls the previous sample from lane 3
+            float4 x_last = set1(x1_[channel]);
+            float4 h_last = set1(h1_[channel]);
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                const float4 x = load(buf + i) * pre;
+                const float4 h = residual(x);
+                const float4 y = kernel(x, h, shift_in(x_last, x), shift_in(h_last, h));
+                store(buf + i, y * post);
+                x_last = x;
+                h_last = h;
+            }
+
+            if (i > 0) {
+                x1_[channel] = lane(x_last, 3);
+                h1_[channel] = lane(h_last, 3);
+            }
+
+            for (; i < size; i++) {
+                buf[i] = processScalar(buf[i], channel);
+            }
+        }
+
+        void ProcessBlockStereo(float *bufL, float *bufR, const size_t size)
+        {
+            ProcessBlock(bufL, size, 0);
+            ProcessBlock(bufR, size, 1);
+        }
+
+    private:
+
+        // Below this input difference the ADAA quotient loses precision and
+        // the midpoint evaluation is used instead (error is O(dx^2) there).
+        static constexpr float kIllConditioned = 1.0e-5f;
+
+        // Transfer curve
+        static inline simd::float4 shape(const simd::float4 x)
+        {
+            using namespace simd;
+            const float4 xc = clamp(x, set1(-1.0f), set1(1.0f));
+            return xc * (set1(1.5f) - set1(0.5f) * xc * xc);
+        }
+
+        // Antiderivative of the curve minus |x|:
+        //   F(x) = |x| + H(x),  H(x) = 0.75xc^2 - 0.125xc^4 - |xc|,  xc = clamp(x)
+        // H is bounded to [-0.375, 0] so differences of it stay accurate.
+        static inline simd::float4 residual(const simd::float4 x)
+        {
+            using namespace simd;
+            const float4 xc = clamp(x, set1(-1.0f), set1(1.0f));
+            const float4 xc2 = xc * xc;
+            return xc2 * (set1(0.75f) - set1(0.125f) * xc2) - abs(xc);
+        }
+
+        static inline simd::float4 kernel(const simd::float4 x, const simd::float4 h,
+                                          const simd::float4 xp, const simd::float4 hp)
+        {
+            using namespace simd;
+            const float4 dx  = x - xp;
+            const float4 ill = less(abs(dx), set1(kIllConditioned));
+            const float4 num = (abs(x) - abs(xp)) + (h - hp);
+            const float4 adaa = num / select(ill, set1(1.0f), dx);
+            const float4 mid  = shape((x + xp) * set1(0.5f));
+            return select(ill, mid, adaa);
+        }
+
+        inline float processScalar(const float in, const int channel)
+        {
+            const float x   = in * pre_gain_;
+            const float xc  = daisysp::fclamp(x, -1.0f, 1.0f);
+            const float xc2 = xc * xc;
+            const float h   = xc2 * (0.75f - 0.125f * xc2) - std::fabs(xc);
+
+            const float xp = x1_[channel];
+            const float dx = x - xp;
+            x1_[channel] = x;
+
+            const float num = (std::fabs(x) - std::fabs(xp)) + (h - h1_[channel]);
+            h1_[channel] = h;
+
+            const float xm = daisysp::fclamp(0.5f * (x + xp), -1.0f, 1.0f);
+            const float mid = xm * (1.5f - 0.5f * xm * xm);
+            const bool ill = std::fabs(dx) < kIllConditioned;
+            const float y = ill ? mid : num / (ill ? 1.0f : dx);
+            return y * post_gain_;
+        }
+
+        float drive_;
+        float pre_gain_;
+        float post_gain_;
+
+        // Previous pre-gain input and its residual antiderivative, per channel
+        float x1_[2];
+        float h1_[2];
+};
+
+}
+
+#endif
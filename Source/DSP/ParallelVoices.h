@@ -0,0 +1,135 @@
+#pragma once
+#ifndef INFS_PARALLELVOICES_H
+#define INFS_PARALLELVOICES_H
+
+#include "RealtimeWorkerPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace infrasonic
+{
+/**
+ * Renders a set of independent voices into one stereo output, spreading
+ * them across a RealtimeWorkerPool when there are enough of them to pay
+ * for the hand-off.
+ *
+ * Each voice renders into its own scratch buffers (no sharing, no atomics
+ * in the inner loop), then the calling thread sums them into the output.
+ * Below the parallel threshold, or without a pool, voices are rendered
+ * one after another on the calling thread.
+ *
+ * Voice must provide ProcessBlock(const float *in, float *outL, float *outR,
+ * size_t size), e.g. FeedbackSynth::Engine.
+ */
+template <typename Voice>
+class ParallelVoices
+{
+  public:
+    /// Fewer voices than this are rendered serially
+    static constexpr size_t kDefaultParallelThreshold = 4;
+
+    /** Allocates scratch space. Not real-time safe.
+        \param max_voices Largest voice count passed to Process()
+        \param max_block  Larger blocks are rendered in chunks of this size
+    */
+    void Prepare(size_t max_voices, size_t max_block)
+    {
+        max_voices_ = max_voices;
+        max_block_  = std::max<size_t>(1, max_block);
+        scratch_.assign(max_voices_ * 2 * max_block_, 0.0f);
+    }
+
+    /// May be null; pool must outlive this object
+    void SetPool(RealtimeWorkerPool *pool) { pool_ = pool; }
+
+    void SetParallelThreshold(size_t min_voices) { threshold_ = min_voices; }
+
+    /// True when num_voices would be rendered on the pool
+    bool IsParallel(size_t num_voices) const
+    {
+        return pool_ != nullptr && pool_->GetNumWorkers() > 0 && num_voices >= threshold_
+               && num_voices > 1;
+    }
+
+    /** Renders voices[0..num_voices) from the same input and writes their
+        sum to outL/outR (overwriting them). num_voices must not exceed the
+        prepared maximum.
+    */
+    void Process(Voice *const *voices, size_t num_voices, const float *in, float *outL,
+                 float *outR, size_t size)
+    {
+        num_voices = std::min(num_voices, max_voices_);
+
+        for (size_t offset = 0; offset < size; offset += max_block_) {
+            const size_t chunk = std::min(max_block_, size - offset);
+
+            job_.self   = this;
+            job_.voices = voices;
+            job_.in     = in + offset;
+            job_.size   = chunk;
+
+            if (IsParallel(num_voices)) {
+                pool_->Run(&RenderTask, &job_, static_cast<int>(num_voices));
+            } else {
+                for (size_t v = 0; v < num_voices; v++) {
+                    RenderTask(&job_, static_cast<int>(v));
+                }
+            }
+
+            Sum(num_voices, outL + offset, outR + offset, chunk);
+        }
+    }
+
+  private:
+    struct Job
+    {
+        ParallelVoices *self   = nullptr;
+        Voice *const   *voices = nullptr;
+        const float    *in     = nullptr;
+        size_t          size   = 0;
+    };
+
+    float *ScratchL(size_t voice) { return scratch_.data() + voice * 2 * max_block_; }
+    float *ScratchR(size_t voice) { return ScratchL(voice) + max_block_; }
+
+    static void RenderTask(void *context, int index)
+    {
+        auto      &job   = *static_cast<Job *>(context);
+        const auto voice = static_cast<size_t>(index);
+        job.voices[voice]->ProcessBlock(
+            job.in, job.self->ScratchL(voice), job.self->ScratchR(voice), job.size);
+    }
+
+    // Sum-reduction on the calling thread, after the pool's barrier
+    void Sum(size_t num_voices, float *outL, float *outR, size_t size)
+    {
+        if (num_voices == 0) {
+            std::fill(outL, outL + size, 0.0f);
+            std::fill(outR, outR + size, 0.0f);
+            return;
+        }
+
+        std::copy(ScratchL(0), ScratchL(0) + size, outL);
+        std::copy(ScratchR(0), ScratchR(0) + size, outR);
+        for (size_t v = 1; v < num_voices; v++) {
+            const float *l = ScratchL(v);
+            const float *r = ScratchR(v);
+            for (size_t i = 0; i < size; i++) {
+                outL[i] += l[i];
+                outR[i] += r[i];
+            }
+        }
+    }
+
+    RealtimeWorkerPool *pool_       = nullptr;
+    size_t              threshold_  = kDefaultParallelThreshold;
+    size_t              max_voices_ = 0;
+    size_t              max_block_  = 1;
+    std::vector<float>  scratch_;
+    Job                 job_;
+};
+
+} // namespace infrasonic
+
+#endif
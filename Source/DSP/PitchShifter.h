@@ -1,7 +1,7 @@
 #pragma once
+#include "DSPMath.h"
 #include <vector>
 #include <cmath>
-#include <JuceHeader.h>
 
 class PitchShifter
 {
@@ -14,7 +14,8 @@ public:
         sr = sampleRate;
         // Buffer size: 200ms should be plenty for the window
         bufferSize = static_cast<int>(sr * 0.2f); 
-        buffer.resize(bufferSize, 0.0f);
+        // Re-prepares keep the allocation unless the buffer has to grow
+        buffer.assign(bufferSize, 0.0f);
         writePos = 0;
         phase = 0.0f;
         
@@ -26,7 +27,7 @@ public:
     void SetShift(float semitones)
     {
         // Ratio = 2^(semitones/12)
-        float ratio = std::pow(2.0f, semitones / 12.0f);
+        float ratio = infrasonic::fastmath::exp2(semitones * (1.0f / 12.0f));
         
         // d(Delay)/dt = 1 - ratio
         // phase goes 0->1. delay = phase * windowSize.
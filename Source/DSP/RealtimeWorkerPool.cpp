@@ -0,0 +1,185 @@
+#include "RealtimeWorkerPool.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+using namespace infrasonic;
+
+namespace {
+
+inline void CpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+// Best-effort: needs privileges on Linux, which a plugin host may not have
+void RequestRealtimePriority()
+{
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#elif defined(__unix__) || defined(__APPLE__)
+    sched_param param{};
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
+
+} // namespace
+
+RealtimeWorkerPool::RealtimeWorkerPool(int num_workers)
+{
+    if (num_workers <= 0) {
+        const int hw = static_cast<int>(std::thread::hardware_concurrency());
+        num_workers = hw > 1 ? hw - 1 : 0;
+    }
+
+    threads_.reserve(static_cast<size_t>(num_workers));
+    for (int i = 0; i < num_workers; i++) {
+        threads_.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    quit_.store(true);
+    // New epoch with no tasks wakes everyone up
+    work_.store((static_cast<uint64_t>(EpochOf(work_.load()) + 1)) << 32);
+    work_.notify_all();
+
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+void RealtimeWorkerPool::SetWorkerSetup(std::function<void()> setup)
+{
+    {
+        std::lock_guard<std::mutex> lock(setup_mutex_);
+        setup_ = std::move(setup);
+    }
+    setup_generation_.fetch_add(1);
+}
+
+void RealtimeWorkerPool::Run(TaskFn fn, void *context, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    if (threads_.empty() || count == 1) {
+        for (int i = 0; i < count; i++) {
+            fn(context, i);
+        }
+        return;
+    }
+
+    // Workers still draining the previous run read the other slot. The one
+    // written here was last used two runs ago, which every worker has
+    // finished claiming from: its epoch no longer matches work_.
+    const uint32_t epoch = EpochOf(work_.load(std::memory_order_relaxed)) + 1;
+    Job &job = jobs_[SlotOf(epoch)];
+    job.fn.store(fn, std::memory_order_release);
+    job.context.store(context, std::memory_order_release);
+    job.count.store(count, std::memory_order_release);
+    remaining_.store(count, std::memory_order_relaxed);
+
+    // Publishing the new epoch releases the fields above to the workers
+    work_.store(static_cast<uint64_t>(epoch) << 32);
+    if (sleeping_workers_.load() > 0) {
+        work_.notify_all();
+    }
+
+    Drain(epoch);
+
+    // Barrier: spin, then block until the last worker finishes
+    for (int spin = 0; remaining_.load(std::memory_order_acquire) > 0; spin++) {
+        if (spin < kSpinIterations) {
+            CpuRelax();
+            continue;
+        }
+        caller_waiting_.store(true);
+        int left = remaining_.load();
+        while (left > 0) {
+            remaining_.wait(left);
+            left = remaining_.load();
+        }
+        caller_waiting_.store(false);
+    }
+}
+
+void RealtimeWorkerPool::Drain(uint32_t epoch)
+{
+    // If a slow worker reads any of these from a later run reusing the
+    // slot, the acquire makes that run's newer epoch visible below, and
+    // nothing is claimed
+    const Job &job = jobs_[SlotOf(epoch)];
+    TaskFn fn = job.fn.load(std::memory_order_acquire);
+    void  *context = job.context.load(std::memory_order_acquire);
+    const uint32_t count = static_cast<uint32_t>(job.count.load(std::memory_order_acquire));
+
+    uint64_t work = work_.load(std::memory_order_acquire);
+    for (;;) {
+        if (EpochOf(work) != epoch || IndexOf(work) >= count) {
+            return;
+        }
+        if (!work_.compare_exchange_weak(work, work + 1, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        fn(context, static_cast<int>(IndexOf(work)));
+
+        if (remaining_.fetch_sub(1) == 1 && caller_waiting_.load()) {
+            remaining_.notify_one();
+        }
+        work = work_.load(std::memory_order_acquire);
+    }
+}
+
+void RealtimeWorkerPool::WorkerLoop()
+{
+    RequestRealtimePriority();
+
+    uint32_t seen_epoch = 0;
+    uint32_t seen_setup = 0;
+
+    while (!quit_.load(std::memory_order_relaxed)) {
+        const uint32_t setup_generation = setup_generation_.load();
+        if (setup_generation != seen_setup) {
+            seen_setup = setup_generation;
+            std::lock_guard<std::mutex> lock(setup_mutex_);
+            if (setup_) {
+                setup_();
+            }
+        }
+
+        uint64_t work = work_.load(std::memory_order_acquire);
+        for (int spin = 0; EpochOf(work) == seen_epoch; spin++) {
+            if (spin < kSpinIterations) {
+                CpuRelax();
+            } else {
+                sleeping_workers_.fetch_add(1);
+                work_.wait(work);
+                sleeping_workers_.fetch_sub(1);
+                spin = 0;
+            }
+            work = work_.load(std::memory_order_acquire);
+        }
+
+        seen_epoch = EpochOf(work);
+        if (!quit_.load(std::memory_order_relaxed)) {
+            Drain(seen_epoch);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#ifndef INFS_REALTIMEWORKERPOOL_H
+#define INFS_REALTIMEWORKERPOOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace infrasonic
+{
+/**
+ * Worker threads that help the audio thread run independent tasks within
+ * one block.
+ *
+ * Run() publishes a task count, works on tasks itself and returns once
+ * every task is done. Tasks are claimed from a single atomic counter tagged
+ * with the run's epoch. Consecutive runs keep their function, context and
+ * count in alternate slots, so a worker that wakes late only ever sees the
+ * task count of the run whose epoch it claims against, and cannot claim a
+ * task once that run is over. Idle workers and the waiting audio thread spin for a
+ * short while before blocking on the atomic (futex/ulock/WaitOnAddress),
+ * and are only woken with a syscall if they actually went to sleep.
+ *
+ * Workers ask for real-time scheduling when they start. That is best-effort
+ * and may be refused by the OS. Hosts with audio workgroups (macOS) should
+ * also pass a join function to SetWorkerSetup().
+ */
+class RealtimeWorkerPool
+{
+  public:
+    using TaskFn = void (*)(void *context, int index);
+
+    /** Starts the worker threads. Not real-time safe.
+        \param num_workers Helper threads; 0 uses one fewer than the number
+                           of hardware threads
+    */
+    explicit RealtimeWorkerPool(int num_workers = 0);
+    ~RealtimeWorkerPool();
+
+    int GetNumWorkers() const { return static_cast<int>(threads_.size()); }
+
+    /** Runs fn(context, i) for every i in [0, count) on the calling thread
+        and the workers, and returns when all have finished. Never
+        allocates or locks. One caller at a time.
+    */
+    void Run(TaskFn fn, void *context, int count);
+
+    /** Runs setup once on every worker thread, on that thread, before the
+        next task it picks up (e.g. to join the host's audio workgroup).
+        Not real-time safe.
+    */
+    void SetWorkerSetup(std::function<void()> setup);
+
+  private:
+    static constexpr int kSpinIterations = 4096;
+
+    void WorkerLoop();
+    void Drain(uint32_t epoch);
+
+    static uint32_t EpochOf(uint64_t work) { return static_cast<uint32_t>(work >> 32); }
+    static uint32_t IndexOf(uint64_t work) { return static_cast<uint32_t>(work); }
+
+    // What one run does. Run() fills the slot for the new epoch while the
+    // previous run's slot may still be read by late workers.
+    struct Job {
+        std::atomic<TaskFn> fn{nullptr};
+        std::atomic<void *> context{nullptr};
+        std::atomic<int>    count{0};
+    };
+
+    static size_t SlotOf(uint32_t epoch) { return epoch & 1u; }
+
+    // High 32 bits: run epoch, low 32 bits: next unclaimed task
+    std::atomic<uint64_t> work_{0};
+    Job                   jobs_[2];
+    std::atomic<int>      remaining_{0};
+    std::atomic<int>      sleeping_workers_{0};
+    std::atomic<bool>     caller_waiting_{false};
+    std::atomic<bool>     quit_{false};
+
+    std::mutex            setup_mutex_;
+    std::function<void()> setup_;
+    std::atomic<uint32_t> setup_generation_{0};
+
+    std::vector<std::thread> threads_;
+
+    RealtimeWorkerPool(const RealtimeWorkerPool &) = delete;
+    RealtimeWorkerPool &operator=(const RealtimeWorkerPool &) = delete;
+};
+
+} // namespace infrasonic
+
+#endif
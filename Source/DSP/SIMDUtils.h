@@ -0,0 +1,178 @@
+#pragma once
+#ifndef INFS_SIMDUTILS_H
+#define INFS_SIMDUTILS_H
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INFS_SIMD_SSE 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define INFS_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace infrasonic {
+namespace simd {
+
+/**
+ * Four packed single precision lanes.
+ *
+ * Used both for stereo pairs (L/R in lanes 0/1) inside the per-sample loop
+ * and for processing blocks four samples at a time. Maps to SSE2 on x86,
+ * NEON on AArch64 and plain scalar code everywhere else.
+ *
+ * Comparisons return a lane mask (all bits set / clear) that is only
+ * meant to be consumed by select().
+ */
+struct float4 {
+#if INFS_SIMD_SSE
+    __m128 v;
+#elif INFS_SIMD_NEON
+    float32x4_t v;
+#else
+    float v[4];
+#endif
+};
+
+#if INFS_SIMD_SSE
+
+inline float4 load(const float *p)              { return { _mm_loadu_ps(p) }; }
+inline void   store(float *p, const float4 a)   { _mm_storeu_ps(p, a.v); }
+inline float4 set1(const float x)               { return { _mm_set1_ps(x) }; }
+inline float4 set(float a, float b, float c, float d) { return { _mm_setr_ps(a, b, c, d) }; }
+
+inline float4 operator+(const float4 a, const float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+inline float4 operator-(const float4 a, const float4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline float4 operator*(const float4 a, const float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline float4 operator/(const float4 a, const float4 b) { return { _mm_div_ps(a.v, b.v) }; }
+
+inline float4 min(const float4 a, const float4 b) { return { _mm_min_ps(a.v, b.v) }; }
+inline float4 max(const float4 a, const float4 b) { return { _mm_max_ps(a.v, b.v) }; }
+inline float4 abs(const float4 a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+
+inline float4 less(const float4 a, const float4 b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+inline float4 select(const float4 mask, const float4 a, const float4 b)
+{
+    return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) };
+}
+
+/// Returns { prev[3], a[0], a[1], a[2] } i.e. a delayed by one lane.
+inline float4 shift_in(const float4 prev, const float4 a)
+{
+    const __m128 t = _mm_shuffle_ps(prev.v, a.v, _MM_SHUFFLE(0, 0, 3, 3));
+    return { _mm_shuffle_ps(t, a.v, _MM_SHUFFLE(2, 1, 2, 0)) };
+}
+
+/// Returns { a[0], a[1], b[0], b[1] }
+inline float4 combine_low(const float4 a, const float4 b) { return { _mm_movelh_ps(a.v, b.v) }; }
+
+/// Returns { a[3], a[2], a[1], a[0] }
+inline float4 reverse(const float4 a) { return { _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(0, 1, 2, 3)) }; }
+
+inline float lane(const float4 a, const int i)
+{
+    alignas(16) float tmp[4];
+    _mm_store_ps(tmp, a.v);
+    return tmp[i];
+}
+
+#elif INFS_SIMD_NEON
+
+inline float4 load(const float *p)              { return { vld1q_f32(p) }; }
+inline void   store(float *p, const float4 a)   { vst1q_f32(p, a.v); }
+inline float4 set1(const float x)               { return { vdupq_n_f32(x) }; }
+inline float4 set(float a, float b, float c, float d)
+{
+    const float tmp[4] = { a, b, c, d };
+    return { vld1q_f32(tmp) };
+}
+
+inline float4 operator+(const float4 a, const float4 b) { return { vaddq_f32(a.v, b.v) }; }
+inline float4 operator-(const float4 a, const float4 b) { return { vsubq_f32(a.v, b.v) }; }
+inline float4 operator*(const float4 a, const float4 b) { return { vmulq_f32(a.v, b.v) }; }
+inline float4 operator/(const float4 a, const float4 b) { return { vdivq_f32(a.v, b.v) }; }
+
+inline float4 min(const float4 a, const float4 b) { return { vminq_f32(a.v, b.v) }; }
+inline float4 max(const float4 a, const float4 b) { return { vmaxq_f32(a.v, b.v) }; }
+inline float4 abs(const float4 a) { return { vabsq_f32(a.v) }; }
+
+inline float4 less(const float4 a, const float4 b)
+{
+    return { vreinterpretq_f32_u32(vcltq_f32(a.v, b.v)) };
+}
+inline float4 select(const float4 mask, const float4 a, const float4 b)
+{
+    return { vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v) };
+}
+
+/// Returns { prev[3], a[0], a[1], a[2] } i.e. a delayed by one lane.
+inline float4 shift_in(const float4 prev, const float4 a) { return { vextq_f32(prev.v, a.v, 3) }; }
+
+/// Returns { a[0], a[1], b[0], b[1] }
+inline float4 combine_low(const float4 a, const float4 b)
+{
+    return { vcombine_f32(vget_low_f32(a.v), vget_low_f32(b.v)) };
+}
+
+/// Returns { a[3], a[2], a[1], a[0] }
+inline float4 reverse(const float4 a)
+{
+    const float32x4_t r = vrev64q_f32(a.v);
+    return { vextq_f32(r, r, 2) };
+}
+
+inline float lane(const float4 a, const int i)
+{
+    float tmp[4];
+    vst1q_f32(tmp, a.v);
+    return tmp[i];
+}
+
+#else
+
+inline float4 load(const float *p)            { return { { p[0], p[1], p[2], p[3] } }; }
+inline void   store(float *p, const float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline float4 set1(const float x)             { return { { x, x, x, x } }; }
+inline float4 set(float a, float b, float c, float d) { return { { a, b, c, d } }; }
+
+#define INFS_SIMD_SCALAR_OP(expr) \
+    float4 r; for (int i = 0; i < 4; i++) { r.v[i] = (expr); } return r;
+
+inline float4 operator+(const float4 a, const float4 b) { INFS_SIMD_SCALAR_OP(a.v[i] + b.v[i]) }
+inline float4 operator-(const float4 a, const float4 b) { INFS_SIMD_SCALAR_OP(a.v[i] - b.v[i]) }
+inline float4 operator*(const float4 a, const float4 b) { INFS_SIMD_SCALAR_OP(a.v[i] * b.v[i]) }
+inline float4 operator/(const float4 a, const float4 b) { INFS_SIMD_SCALAR_OP(a.v[i] / b.v[i]) }
+
+inline float4 min(const float4 a, const float4 b) { INFS_SIMD_SCALAR_OP(a.v[i] < b.v[i] ? a.v[i] : b.v[i]) }
+inline float4 max(const float4 a, const float4 b) { INFS_SIMD_SCALAR_OP(a.v[i] > b.v[i] ? a.v[i] : b.v[i]) }
+inline float4 abs(const float4 a) { INFS_SIMD_SCALAR_OP(a.v[i] < 0.0f ? -a.v[i] : a.v[i]) }
+
+// Scalar masks are stored as 1.0f / 0.0f, which select() below understands.
+inline float4 less(const float4 a, const float4 b) { INFS_SIMD_SCALAR_OP(a.v[i] < b.v[i] ? 1.0f : 0.0f) }
+inline float4 select(const float4 mask, const float4 a, const float4 b)
+{
+    INFS_SIMD_SCALAR_OP(mask.v[i] != 0.0f ? a.v[i] : b.v[i])
+}
+
+#undef INFS_SIMD_SCALAR_OP
+
+/// Returns { prev[3], a[0], a[1], a[2] } i.e. a delayed by one lane.
+inline float4 shift_in(const float4 prev, const float4 a) { return { { prev.v[3], a.v[0], a.v[1], a.v[2] } }; }
+
+/// Returns { a[0], a[1], b[0], b[1] }
+inline float4 combine_low(const float4 a, const float4 b) { return { { a.v[0], a.v[1], b.v[0], b.v[1] } }; }
+
+/// Returns { a[3], a[2], a[1], a[0] }
+inline float4 reverse(const float4 a) { return { { a.v[3], a.v[2], a.v[1], a.v[0] } }; }
+
+inline float lane(const float4 a, const int i) { return a.v[i]; }
+
+#endif
+
+inline float4 clamp(const float4 x, const float4 lo, const float4 hi) { return min(max(x, lo), hi); }
+
+} // namespace simd
+} // namespace infrasonic
+
+#endif
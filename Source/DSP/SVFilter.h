@@ -0,0 +1,195 @@
+#pragma once
+#ifndef INFS_SVFILTER_H
+#define INFS_SVFILTER_H
+
+#include "BiquadFilters.h"
+#include "DSPMath.h"
+#include "DSPUtils.h"
+#include "SIMDUtils.h"
+
+namespace infrasonic {
+
+/**
+ * @brief
+ * 2nd order state variable filter, discretised with the topology-preserving
+ * transform (trapezoidal integrators, zero-delay feedback; Zavalishin/Simper).
+ *
+ *   - Lowpass, bandpass and highpass all come out of the same structure
+ *   - The state is the integrators' content rather than past samples, so
+ *     the filter stays stable and click-free while the cutoff moves every
+ *     sample. Same response as the equivalent BiquadCascade section.
+ *   - Cutoff changes glide per sample over the lag time; the per-sample
+ *     update is a one-pole step and a division, the tan() prewarp only
+ *     happens in SetCutoff()
+ *   - Stereo processing runs both channels in one SIMD register
+ *
+ * @tparam FilterType Response returned by Process() / ProcessStereo()
+ */
+template<BiquadSection::FilterType FilterType>
+class SVFilter {
+
+    public:
+
+        /// All three responses for one input sample
+        struct Outputs {
+            float lp, bp, hp;
+        };
+
+        SVFilter() {}
+        ~SVFilter() {}
+
+        void Init(const float sample_rate)
+        {
+            sample_rate_ = sample_rate;
+            k_ = 1.0f / 0.70710678f; // Butterworth
+            SetLagTime(0.0f);
+            SetCutoff(sample_rate * 0.25f, true);
+            Reset();
+        }
+
+        /**
+         * @brief Set the approximate lag time (smoothing) for cutoff changes, in seconds
+         */
+        void SetLagTime(const float time_s)
+        {
+            g_smooth_coef_ = onepole_coef(time_s, sample_rate_);
+        }
+
+        /**
+         * @param cutoff_hz Clamped to 1 Hz .. 0.49 * sample rate
+         * @param immediately If true, skips the glide
+         */
+        inline void SetCutoff(const float cutoff_hz, bool immediately = false)
+        {
+            const float hz = daisysp::fclamp(cutoff_hz, 1.f, sample_rate_ * 0.49f);
+            g_target_ = fastmath::tan(PI_F * hz / sample_rate_);
+            if (immediately) {
+                g_ = g_target_;
+                updateCoefficients();
+            }
+        }
+
+        inline void SetQ(const float q)
+        {
+            k_ = 1.0f / daisysp::fmax(q, 0.1f);
+            updateCoefficients();
+        }
+
+        /// Clears the filter state and completes any cutoff glide
+        void Reset()
+        {
+            for (int i = 0; i < 4; i++) {
+                ic1_[i] = ic2_[i] = 0.0f;
+            }
+            g_ = g_target_;
+            updateCoefficients();
+        }
+
+        /// Mono (uses the left channel state), all responses
+        inline Outputs ProcessMulti(const float in)
+        {
+            tick();
+            const float v3 = in - ic2_[0];
+            const float v1 = a1_ * ic1_[0] + a2_ * v3;
+            const float v2 = ic2_[0] + a2_ * ic1_[0] + a3_ * v3;
+            ic1_[0] = 2.0f * v1 - ic1_[0];
+            ic2_[0] = 2.0f * v2 - ic2_[0];
+            return { v2, v1, in - k_ * v1 - v2 };
+        }
+
+        inline float Process(const float in)
+        {
+            const Outputs out = ProcessMulti(in);
+            if constexpr (FilterType == BiquadSection::FilterType::HighPass) {
+                return out.hp;
+            } else if constexpr (FilterType == BiquadSection::FilterType::BandPass) {
+                return out.bp;
+            } else {
+                return out.lp;
+            }
+        }
+
+        /// In-place stereo processing
+        inline void ProcessStereo(float &sampL, float &sampR)
+        {
+            tick();
+            const simd::float4 v0 = simd::set(sampL, sampR, 0.0f, 0.0f);
+            const simd::float4 a1 = simd::set1(a1_);
+            const simd::float4 a2 = simd::set1(a2_);
+            const simd::float4 a3 = simd::set1(a3_);
+            const simd::float4 two = simd::set1(2.0f);
+
+            const simd::float4 ic1 = simd::load(ic1_);
+            const simd::float4 ic2 = simd::load(ic2_);
+
+            const simd::float4 v3 = v0 - ic2;
+            const simd::float4 v1 = a1 * ic1 + a2 * v3;
+            const simd::float4 v2 = ic2 + a2 * ic1 + a3 * v3;
+            simd::store(ic1_, two * v1 - ic1);
+            simd::store(ic2_, two * v2 - ic2);
+
+            simd::float4 out;
+            if constexpr (FilterType == BiquadSection::FilterType::HighPass) {
+                out = v0 - simd::set1(k_) * v1 - v2;
+            } else if constexpr (FilterType == BiquadSection::FilterType::BandPass) {
+                out = v1;
+            } else {
+                out = v2;
+            }
+            sampL = simd::lane(out, 0);
+            sampR = simd::lane(out, 1);
+        }
+
+    private:
+
+        SVFilter(const SVFilter &other) = delete;
+        SVFilter(SVFilter &&other) = delete;
+        SVFilter& operator=(const SVFilter &other) = delete;
+        SVFilter& operator=(SVFilter &&other) = delete;
+
+        float sample_rate_ = 48000.0f;
+
+        // g = tan(pi * fc / fs), k = 1 / Q
+        float g_ = 0.0f;
+        float g_target_ = 0.0f;
+        float g_smooth_coef_ = 1.0f;
+        float k_ = 1.0f;
+
+        float a1_ = 1.0f, a2_ = 0.0f, a3_ = 0.0f;
+
+        // Integrator states, left/right in lanes 0/1
+        alignas(16) float ic1_[4] = {0, 0, 0, 0};
+        alignas(16) float ic2_[4] = {0, 0, 0, 0};
+
+        inline void updateCoefficients()
+        {
+            a1_ = 1.0f / (1.0f + g_ * (g_ + k_));
+            a2_ = g_ * a1_;
+            a3_ = g_ * a2_;
+        }
+
+        /// Per-sample glide towards the target cutoff, landing on it exactly
+        inline void tick()
+        {
+            if (g_ != g_target_) {
+                const float delta = g_target_ - g_;
+                g_ = (delta * delta > 1e-12f * g_target_ * g_target_)
+                         ? g_ + g_smooth_coef_ * delta
+                         : g_target_;
+                updateCoefficients();
+            }
+        }
+};
+
+/// 12dB/Oct resonant lowpass state variable filter
+using LowPassSVF = SVFilter<BiquadSection::FilterType::LowPass>;
+
+/// 12dB/Oct resonant highpass state variable filter
+using HighPassSVF = SVFilter<BiquadSection::FilterType::HighPass>;
+
+/// 12dB/Oct resonant bandpass state variable filter
+using BandPassSVF = SVFilter<BiquadSection::FilterType::BandPass>;
+
+}
+
+#endif
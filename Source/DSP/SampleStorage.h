@@ -0,0 +1,252 @@
+#pragma once
+#ifndef INFS_SAMPLESTORAGE_H
+#define INFS_SAMPLESTORAGE_H
+
+#include "SIMDUtils.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace infrasonic {
+
+/**
+ * @brief
+ * Formats a delay line can keep its samples in (see daisysp::DelayLine).
+ *
+ *   - Float32: full precision
+ *   - Int16:   fixed point, with +-4 (+12 dBFS) at the int16 limits. Louder
+ *              samples saturate; quantisation noise sits around -89 dBFS.
+ *   - Float16: IEEE half precision, 11 significant bits at any level.
+ *              Saturates at +-65504.
+ *
+ * The 16-bit formats halve the memory and bandwidth of a line. Conversions
+ * round to nearest even, and single samples convert exactly as SIMD blocks
+ * do, so block and per-sample processing stay bit-exact.
+ */
+enum class SampleFormat {
+    Float32,
+    Int16,
+    Float16
+};
+
+namespace storage {
+
+#if !INFS_SIMD_NEON
+
+inline uint32_t bits(const float x)
+{
+    uint32_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+inline float from_bits(const uint32_t u)
+{
+    float x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+/// Rounds to nearest, saturating at the int16 range
+inline int16_t to_int16(const float x)
+{
+    return static_cast<int16_t>(std::lrint(std::fmin(std::fmax(x, -32768.0f), 32767.0f)));
+}
+
+inline float from_int16(const int16_t x) { return static_cast<float>(x); }
+
+inline uint16_t to_half(const float x)
+{
+    const uint32_t sign = bits(x) & 0x80000000u;
+    // Clamped to the largest finite half, so infinities and NaN never get stored
+    const uint32_t mag = bits(std::fmin(std::fabs(x), 65504.0f));
+    uint32_t h;
+    if (mag < (113u << 23)) {
+        // Below the smallest normal half: adding this lets the FPU round
+        // the mantissa into place
+        const float denorm_magic = from_bits(((127u - 15u) + (23u - 10u) + 1u) << 23);
+        h = bits(from_bits(mag) + denorm_magic) - bits(denorm_magic);
+    } else {
+        // Rebias the exponent and round the mantissa to nearest even
+        h = (mag - (112u << 23) + 0xfffu + ((mag >> 13) & 1u)) >> 13;
+    }
+    return static_cast<uint16_t>(h | (sign >> 16));
+}
+
+inline float from_half(const uint16_t h)
+{
+    const uint32_t expmant = h & 0x7fffu;
+    // Denormals are converted as integers so they survive flush-to-zero
+    const float mag = expmant < 0x0400u ? static_cast<float>(expmant) * 5.9604645e-8f
+                                        : from_bits((expmant << 13) + (112u << 23));
+    return from_bits(bits(mag) | (static_cast<uint32_t>(h & 0x8000u) << 16));
+}
+
+#endif
+
+#if INFS_SIMD_SSE
+
+inline simd::float4 load_int16(const int16_t *p)
+{
+    const __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+    return { _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)) };
+}
+
+inline void store_int16(int16_t *p, const simd::float4 a)
+{
+    const __m128 c = _mm_min_ps(_mm_max_ps(a.v, _mm_set1_ps(-32768.0f)), _mm_set1_ps(32767.0f));
+    const __m128i i = _mm_cvtps_epi32(c);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_packs_epi32(i, i));
+}
+
+/// Same steps as to_half(), both paths computed and selected per lane
+inline void store_half(uint16_t *p, const simd::float4 a)
+{
+    const __m128i x = _mm_castps_si128(a.v);
+    const __m128i sign = _mm_and_si128(x, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+    const __m128 mag_f = _mm_min_ps(_mm_castsi128_ps(_mm_xor_si128(x, sign)), _mm_set1_ps(65504.0f));
+    const __m128i mag = _mm_castps_si128(mag_f);
+
+    const __m128 denorm_magic = _mm_castsi128_ps(_mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23));
+    const __m128i denorm = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(mag_f, denorm_magic)),
+                                         _mm_castps_si128(denorm_magic));
+
+    const __m128i mant_odd = _mm_and_si128(_mm_srli_epi32(mag, 13), _mm_set1_epi32(1));
+    const __m128i rebiased = _mm_add_epi32(mag, _mm_set1_epi32(0xfff - (112 << 23)));
+    const __m128i normal = _mm_srli_epi32(_mm_add_epi32(rebiased, mant_odd), 13);
+
+    const __m128i is_denorm = _mm_cmplt_epi32(mag, _mm_set1_epi32(113 << 23));
+    __m128i h = _mm_or_si128(_mm_and_si128(is_denorm, denorm), _mm_andnot_si128(is_denorm, normal));
+    h = _mm_or_si128(h, _mm_srli_epi32(sign, 16));
+
+    // Sign-extend so the signed pack keeps all 16 bits
+    h = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_packs_epi32(h, h));
+}
+
+inline simd::float4 load_half(const uint16_t *p)
+{
+    const __m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)),
+                                         _mm_setzero_si128());
+    const __m128i expmant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+    const __m128 normal = _mm_castsi128_ps(_mm_add_epi32(_mm_slli_epi32(expmant, 13), _mm_set1_epi32(112 << 23)));
+    const __m128 denorm = _mm_mul_ps(_mm_cvtepi32_ps(expmant), _mm_set1_ps(5.9604645e-8f));
+    const __m128 is_denorm = _mm_castsi128_ps(_mm_cmplt_epi32(expmant, _mm_set1_epi32(0x0400)));
+    const __m128 mag = _mm_or_ps(_mm_and_ps(is_denorm, denorm), _mm_andnot_ps(is_denorm, normal));
+    const __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+    return { _mm_or_ps(mag, _mm_castsi128_ps(sign)) };
+}
+
+#elif INFS_SIMD_NEON
+
+inline simd::float4 load_int16(const int16_t *p)
+{
+    return { vcvtq_f32_s32(vmovl_s16(vld1_s16(p))) };
+}
+
+inline void store_int16(int16_t *p, const simd::float4 a)
+{
+    const float32x4_t c = vminnmq_f32(vmaxnmq_f32(a.v, vdupq_n_f32(-32768.0f)), vdupq_n_f32(32767.0f));
+    vst1_s16(p, vqmovn_s32(vcvtnq_s32_f32(c)));
+}
+
+inline void store_half(uint16_t *p, const simd::float4 a)
+{
+    const float32x4_t c = vminnmq_f32(vmaxnmq_f32(a.v, vdupq_n_f32(-65504.0f)), vdupq_n_f32(65504.0f));
+    vst1_u16(p, vreinterpret_u16_f16(vcvt_f16_f32(c)));
+}
+
+inline simd::float4 load_half(const uint16_t *p)
+{
+    return { vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p))) };
+}
+
+// Single samples go through the vector conversions, so they round the same
+
+inline int16_t to_int16(const float x)
+{
+    int16_t out[4];
+    store_int16(out, simd::set1(x));
+    return out[0];
+}
+
+inline float from_int16(const int16_t x) { return static_cast<float>(x); }
+
+inline uint16_t to_half(const float x)
+{
+    uint16_t out[4];
+    store_half(out, simd::set1(x));
+    return out[0];
+}
+
+inline float from_half(const uint16_t h)
+{
+    const uint16_t in[4] = {h, h, h, h};
+    return simd::lane(load_half(in), 0);
+}
+
+#else
+
+inline simd::float4 load_int16(const int16_t *p)
+{
+    return simd::set(from_int16(p[0]), from_int16(p[1]), from_int16(p[2]), from_int16(p[3]));
+}
+
+inline void store_int16(int16_t *p, const simd::float4 a)
+{
+    for (int i = 0; i < 4; i++) p[i] = to_int16(a.v[i]);
+}
+
+inline simd::float4 load_half(const uint16_t *p)
+{
+    return simd::set(from_half(p[0]), from_half(p[1]), from_half(p[2]), from_half(p[3]));
+}
+
+inline void store_half(uint16_t *p, const simd::float4 a)
+{
+    for (int i = 0; i < 4; i++) p[i] = to_half(a.v[i]);
+}
+
+#endif
+
+} // namespace storage
+
+/// How a line of T keeps its samples. Float32 stores T as is.
+template<typename T, SampleFormat Format>
+struct SampleCodec {
+    using Stored = T;
+    static inline T Decode(const Stored s) { return s; }
+    static inline Stored Encode(const T x) { return x; }
+    static inline simd::float4 Decode4(const Stored *p) { return simd::load(p); }
+    static inline void Encode4(Stored *p, const simd::float4 x) { simd::store(p, x); }
+};
+
+template<>
+struct SampleCodec<float, SampleFormat::Int16> {
+    using Stored = int16_t;
+    /// Level at the int16 limits
+    static constexpr float kFullScale = 4.0f;
+    static inline float Decode(const Stored s) { return storage::from_int16(s) * (kFullScale / 32768.0f); }
+    static inline Stored Encode(const float x) { return storage::to_int16(x * (32768.0f / kFullScale)); }
+    static inline simd::float4 Decode4(const Stored *p)
+    {
+        return storage::load_int16(p) * simd::set1(kFullScale / 32768.0f);
+    }
+    static inline void Encode4(Stored *p, const simd::float4 x)
+    {
+        storage::store_int16(p, x * simd::set1(32768.0f / kFullScale));
+    }
+};
+
+template<>
+struct SampleCodec<float, SampleFormat::Float16> {
+    using Stored = uint16_t;
+    static inline float Decode(const Stored s) { return storage::from_half(s); }
+    static inline Stored Encode(const float x) { return storage::to_half(x); }
+    static inline simd::float4 Decode4(const Stored *p) { return storage::load_half(p); }
+    static inline void Encode4(Stored *p, const simd::float4 x) { storage::store_half(p, x); }
+};
+
+}
+
+#endif
@@ -1,5 +1,7 @@
 #pragma once
+#include "DSPMath.h"
 #include <cmath>
+#include <cstdint>
 #include <numbers>
 
 
@@ -31,6 +33,7 @@ public:
         amp_ = 1.0f;
         waveform_ = WAVE_SINE;
         last_out_ = 0.0f;
+        rand_state_ = 22222u;
     }
 
     void SetRate(float rate) { rate_ = rate; }
@@ -48,7 +51,7 @@ public:
         switch (waveform_)
         {
             case WAVE_SINE:
-                out = std::sin(phase_ * 2.0f * std::numbers::pi_v<float>);
+                out = infrasonic::fastmath::sin(phase_ * 2.0f * std::numbers::pi_v<float>);
                 break;
             case WAVE_TRI:
                 out = phase_ < 0.5f ? 4.0f * phase_ - 1.0f : 1.0f - 4.0f * (phase_ - 0.5f);
@@ -66,7 +69,10 @@ public:
                 // Sample and Hold updates only when phase wraps
                 if (phase_ < inc)
                 {
-                    last_out_ = (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 2.0f - 1.0f;
+                    // Own LCG instead of rand(): deterministic per instance
+                    // and safe to run on several threads
+                    rand_state_ = rand_state_ * 1664525u + 1013904223u;
+                    last_out_ = static_cast<float>(rand_state_ >> 8) * (2.0f / 16777216.0f) - 1.0f;
                 }
                 out = last_out_;
                 break;
@@ -85,6 +91,7 @@ private:
     float amp_;
     Waveform waveform_;
     float last_out_;
+    uint32_t rand_state_ = 22222u;
 };
 
 } // namespace daisysp
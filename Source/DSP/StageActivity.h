@@ -0,0 +1,89 @@
+#pragma once
+#ifndef INFS_STAGEACTIVITY_H
+#define INFS_STAGEACTIVITY_H
+
+#include <cstddef>
+
+namespace infrasonic {
+
+/**
+ * @brief
+ * Bypass state for an optional processing stage.
+ *
+ *   - Active:   the stage is needed and processes its input
+ *   - Tail:     no longer needed, but still running (on silent input) until
+ *               its output has stayed below threshold for the hold time
+ *   - Sleeping: skipped entirely; its output is treated as zero
+ *
+ * Call Begin() once per sample (or block) with whether the stage is needed;
+ * it wakes the stage instantly and returns whether to run it. When it runs,
+ * pass its output to End() so the tail can be tracked.
+ */
+class StageActivity {
+
+    public:
+
+        enum class State { Active, Tail, Sleeping };
+
+        StageActivity() {}
+        ~StageActivity() {}
+
+        /**
+         * @param hold_s    Time the output must stay quiet before sleeping.
+         *                  Should cover the longest internal delay.
+         * @param threshold Linear amplitude treated as silence
+         */
+        void Init(float sample_rate, float hold_s, float threshold = 1e-5f)
+        {
+            hold_samples_ = static_cast<size_t>(hold_s * sample_rate) + 1;
+            threshold_sq_ = threshold * threshold;
+            Reset();
+        }
+
+        /// Puts the stage to sleep, e.g. after its state has been cleared
+        void Reset()
+        {
+            state_ = State::Sleeping;
+            quiet_samples_ = 0;
+        }
+
+        /// Returns true if the stage should run this sample
+        inline bool Begin(bool needed)
+        {
+            if (needed) {
+                state_ = State::Active;
+                quiet_samples_ = 0;
+                return true;
+            }
+            if (state_ == State::Active)
+                state_ = State::Tail;
+            return state_ == State::Tail;
+        }
+
+        /// Output of a sample the stage ran for
+        inline void End(float outL, float outR)
+        {
+            if (state_ != State::Tail)
+                return;
+            if (outL * outL + outR * outR > threshold_sq_)
+                quiet_samples_ = 0;
+            else if (++quiet_samples_ >= hold_samples_)
+                state_ = State::Sleeping;
+        }
+
+        State GetState() const { return state_; }
+        bool IsActive() const { return state_ == State::Active; }
+        bool IsAwake() const { return state_ != State::Sleeping; }
+        bool IsSleeping() const { return state_ == State::Sleeping; }
+
+    private:
+
+        State state_ = State::Sleeping;
+        size_t hold_samples_ = 0;
+        size_t quiet_samples_ = 0;
+        float threshold_sq_ = 1e-10f;
+};
+
+}
+
+#endif
@@ -0,0 +1,182 @@
+#pragma once
+#ifndef INFS_STAGEPROFILER_H
+#define INFS_STAGEPROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace infrasonic {
+
+/**
+ * @brief
+ * Per-stage CPU time accounting for the audio thread.
+ *
+ * Stages are timed with INFS_PROFILE_SCOPE, which compiles to nothing
+ * unless INFS_PROFILING is defined (CMake option DAWDREY_PROFILING).
+ * Time is counted in raw CPU timestamp ticks and summed into plain
+ * per-stage accumulators, which Publish() adds to atomic totals once per
+ * block. The reader only ever loads the totals, so neither side locks.
+ */
+class StageProfiler {
+
+    public:
+
+        enum Stage {
+            // processBlock phases
+            BlockTotal,
+            BlockModulation,
+            BlockGateDrive,
+            BlockEngine,
+            BlockDryWet,
+            BlockWidth,
+            // Engine::Process stages (inside BlockEngine)
+            EngineStrings,
+            EngineDrive,
+            EngineFilters,
+            EngineReverb,
+            EnginePitch,
+            EngineEcho,
+            NumStages
+        };
+
+        static const char *GetStageName(const int stage)
+        {
+            static const char *const names[NumStages] = {
+                "processBlock", "modulation", "gate/drive", "engine", "dry/wet", "width",
+                "strings", "drive", "loop filters", "reverb", "pitch shifter", "echo"
+            };
+            return (stage >= 0 && stage < NumStages) ? names[stage] : "";
+        }
+
+        /// Cumulative totals since construction, read from any thread
+        struct Snapshot {
+            uint64_t ticks[NumStages] = {};
+            uint64_t blocks = 0;
+            uint64_t samples = 0;
+            double   ticks_per_second = 1.0e9;
+        };
+
+        StageProfiler()
+        {
+            calib_ticks_ = Now();
+            calib_time_  = Clock::now();
+        }
+
+        /// Current timestamp in ticks. Cheap enough to call per sample.
+        static inline uint64_t Now()
+        {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+            return ticks;
+#else
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    Clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        // Audio thread only
+        inline void Add(const int stage, const uint64_t ticks)
+        {
+            pending_[stage] += ticks;
+        }
+
+        /// Audio thread, once at the end of every block
+        void Publish(const int num_samples)
+        {
+            for (int i = 0; i < NumStages; i++) {
+                if (pending_[i] != 0) {
+                    totals_[i].fetch_add(pending_[i], std::memory_order_relaxed);
+                    pending_[i] = 0;
+                }
+            }
+            samples_.fetch_add(static_cast<uint64_t>(num_samples), std::memory_order_relaxed);
+            blocks_.fetch_add(1, std::memory_order_release);
+        }
+
+        /// Any thread. Tick rate is calibrated against the wall clock.
+        Snapshot GetSnapshot() const
+        {
+            Snapshot s;
+            s.blocks = blocks_.load(std::memory_order_acquire);
+            s.samples = samples_.load(std::memory_order_relaxed);
+            for (int i = 0; i < NumStages; i++) {
+                s.ticks[i] = totals_[i].load(std::memory_order_relaxed);
+            }
+
+            const double seconds = std::chrono::duration<double>(Clock::now() - calib_time_).count();
+            const uint64_t ticks = Now() - calib_ticks_;
+            if (seconds > 0.01 && ticks > 0) {
+                s.ticks_per_second = static_cast<double>(ticks) / seconds;
+            }
+            return s;
+        }
+
+        /// RAII timer, see INFS_PROFILE_SCOPE
+        class Scope {
+            public:
+                Scope(StageProfiler *profiler, const int stage)
+                    : profiler_(profiler), stage_(stage), start_(profiler ? Now() : 0) {}
+
+                ~Scope()
+                {
+                    if (profiler_ != nullptr) {
+                        profiler_->Add(stage_, Now() - start_);
+                    }
+                }
+
+            private:
+                StageProfiler *profiler_;
+                int            stage_;
+                uint64_t       start_;
+        };
+
+    private:
+
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t pending_[NumStages] = {};
+        std::atomic<uint64_t> totals_[NumStages] = {};
+        std::atomic<uint64_t> blocks_{0};
+        std::atomic<uint64_t> samples_{0};
+
+        uint64_t calib_ticks_;
+        Clock::time_point calib_time_;
+};
+
+}
+
+#define INFS_PROFILE_CONCAT_(a, b) a##b
+#define INFS_PROFILE_CONCAT(a, b) INFS_PROFILE_CONCAT_(a, b)
+
+#if INFS_PROFILING
+/// Times the rest of the enclosing scope into the given stage
+#define INFS_PROFILE_SCOPE(profiler, stage) \
+    ::infrasonic::StageProfiler::Scope INFS_PROFILE_CONCAT(infs_profile_scope_, __LINE__)(profiler, stage)
+/// For phases that do not map onto a scope: take a timestamp...
+#define INFS_PROFILE_MARK(name) const uint64_t name = ::infrasonic::StageProfiler::Now()
+/// ...and later add the time since it to a stage
+#define INFS_PROFILE_SINCE(profiler, stage, name) \
+    (profiler)->Add(stage, ::infrasonic::StageProfiler::Now() - (name))
+/// End of block: make this block's timings visible to readers
+#define INFS_PROFILE_PUBLISH(profiler, num_samples) (profiler)->Publish(num_samples)
+#else
+#define INFS_PROFILE_SCOPE(profiler, stage) ((void)0)
+#define INFS_PROFILE_MARK(name) ((void)0)
+#define INFS_PROFILE_SINCE(profiler, stage, name) ((void)0)
+#define INFS_PROFILE_PUBLISH(profiler, num_samples) ((void)0)
+#endif
+
+#endif
@@ -11,6 +11,8 @@ https://opensource.org/licenses/MIT.
 #define DSY_DELAY_H
 #include <stdlib.h>
 #include <stdint.h>
+#include "../SIMDUtils.h"
+#include "../SampleStorage.h"
 namespace daisysp
 {
 /** Simple Delay line.
@@ -22,11 +24,19 @@ declaration example: (1 second of floats)
 
 DelayLine<float, SAMPLE_RATE> del;
 
+Lines of float can keep their samples in a 16-bit format instead
+(infrasonic::SampleFormat), converting on every read and write.
+
 By: shensley
 */
-template <typename T, size_t max_size>
+template <typename T,
+          size_t                    max_size,
+          infrasonic::SampleFormat format = infrasonic::SampleFormat::Float32>
 class DelayLine
 {
+    using Codec  = infrasonic::SampleCodec<T, format>;
+    using Stored = typename Codec::Stored;
+
   public:
     DelayLine() {}
     ~DelayLine() {}
@@ -34,13 +44,28 @@ class DelayLine
     */
     void Init() { Reset(); }
     /** clears buffer, sets write ptr to 0, and delay to 1 sample.
+        Only the samples written since the previous reset are cleared.
     */
     void Reset()
     {
-        for(size_t i = 0; i < max_size; i++)
+        // Writes start at index 0 and move backwards, so after n writes
+        // (n < max_size) the dirty samples are 0 and [max_size - n + 1, max_size)
+        if(dirty_ >= max_size)
         {
-            line_[i] = T(0);
+            for(size_t i = 0; i < max_size; i++)
+            {
+                line_[i] = Stored(0);
+            }
         }
+        else if(dirty_ > 0)
+        {
+            line_[0] = Stored(0);
+            for(size_t i = max_size - dirty_ + 1; i < max_size; i++)
+            {
+                line_[i] = Stored(0);
+            }
+        }
+        dirty_     = 0;
         write_ptr_ = 0;
         delay_     = 1;
     }
@@ -69,16 +94,17 @@ class DelayLine
     */
     inline void Write(const T sample)
     {
-        line_[write_ptr_] = sample;
+        line_[write_ptr_] = Codec::Encode(sample);
         write_ptr_        = (write_ptr_ - 1 + max_size) % max_size;
+        dirty_ += dirty_ < max_size;
     }
 
     /** returns the next sample of type T in the delay line, interpolated if necessary.
     */
     inline const T Read() const
     {
-        T a = line_[(write_ptr_ + delay_) % max_size];
-        T b = line_[(write_ptr_ + delay_ + 1) % max_size];
+        T a = Codec::Decode(line_[(write_ptr_ + delay_) % max_size]);
+        T b = Codec::Decode(line_[(write_ptr_ + delay_ + 1) % max_size]);
         return a + (b - a) * frac_;
     }
 
@@ -87,8 +113,10 @@ class DelayLine
     {
         int32_t delay_integral   = static_cast<int32_t>(delay);
         float   delay_fractional = delay - static_cast<float>(delay_integral);
-        const T a = line_[(write_ptr_ + delay_integral) % max_size];
-        const T b = line_[(write_ptr_ + delay_integral + 1) % max_size];
+        const T a
+            = Codec::Decode(line_[(write_ptr_ + delay_integral) % max_size]);
+        const T b = Codec::Decode(
+            line_[(write_ptr_ + delay_integral + 1) % max_size]);
         return a + (b - a) * delay_fractional;
     }
 
@@ -98,10 +126,10 @@ class DelayLine
         float   delay_fractional = delay - static_cast<float>(delay_integral);
 
         int32_t     t     = (write_ptr_ + delay_integral + max_size);
-        const T     xm1   = line_[(t - 1) % max_size];
-        const T     x0    = line_[(t) % max_size];
-        const T     x1    = line_[(t + 1) % max_size];
-        const T     x2    = line_[(t + 2) % max_size];
+        const T     xm1   = Codec::Decode(line_[(t - 1) % max_size]);
+        const T     x0    = Codec::Decode(line_[(t) % max_size]);
+        const T     x1    = Codec::Decode(line_[(t + 1) % max_size]);
+        const T     x2    = Codec::Decode(line_[(t + 2) % max_size]);
         const float c     = (x1 - xm1) * 0.5f;
         const float v     = x0 - x1;
         const float w     = c + v;
@@ -111,19 +139,173 @@ class DelayLine
         return (((a * f) - b_neg) * f + c) * f + x0;
     }
 
+    /** Reads size samples ahead: out[i] is what Read(delay[i]) would return
+        after i more writes. Every read must land on a sample already in the
+        line, i.e. delay[i] >= i + 1, so a whole chunk of a feedback loop can
+        be read before any of it is written back.
+    */
+    inline void ReadBlock(const float *delay, T *out, size_t size) const
+    {
+        if(size == 0)
+        {
+            return;
+        }
+
+        // Usual case: every read has the same whole-sample delay and the
+        // block does not wrap, so the samples are contiguous (read backwards
+        // since writes move down the line)
+        const int32_t first_integral = static_cast<int32_t>(delay[0]);
+        bool          same_integral  = true;
+        for(size_t i = 1; i < size; i++)
+        {
+            same_integral &= static_cast<int32_t>(delay[i]) == first_integral;
+        }
+        const size_t t0 = wrap(write_ptr_ + first_integral);
+        if(same_integral && t0 + 1 < max_size && t0 + 1 >= size)
+        {
+            const infrasonic::simd::float4 integral
+                = infrasonic::simd::set1(static_cast<float>(first_integral));
+            size_t i = 0;
+            for(; i + 4 <= size; i += 4)
+            {
+                const infrasonic::simd::float4 av = infrasonic::simd::reverse(
+                    Codec::Decode4(line_ + t0 - i - 3));
+                const infrasonic::simd::float4 bv = infrasonic::simd::reverse(
+                    Codec::Decode4(line_ + t0 - i - 2));
+                const infrasonic::simd::float4 fv
+                    = infrasonic::simd::load(delay + i) - integral;
+                infrasonic::simd::store(out + i, av + (bv - av) * fv);
+            }
+            for(; i < size; i++)
+            {
+                const float delay_fractional
+                    = delay[i] - static_cast<float>(first_integral);
+                const T a = Codec::Decode(line_[t0 - i]);
+                const T b = Codec::Decode(line_[t0 - i + 1]);
+                out[i]    = a + (b - a) * delay_fractional;
+            }
+            return;
+        }
+
+        alignas(16) float a[4], b[4], f[4];
+        size_t i = 0;
+        for(; i + 4 <= size; i += 4)
+        {
+            for(size_t j = 0; j < 4; j++)
+            {
+                const int32_t delay_integral
+                    = static_cast<int32_t>(delay[i + j]);
+                f[j] = delay[i + j] - static_cast<float>(delay_integral);
+                const size_t t = wrap(write_ptr_ + delay_integral - (i + j));
+                a[j] = Codec::Decode(line_[t]);
+                b[j] = Codec::Decode(line_[wrap(t + 1)]);
+            }
+            const infrasonic::simd::float4 av = infrasonic::simd::load(a);
+            const infrasonic::simd::float4 bv = infrasonic::simd::load(b);
+            const infrasonic::simd::float4 fv = infrasonic::simd::load(f);
+            infrasonic::simd::store(out + i, av + (bv - av) * fv);
+        }
+        for(; i < size; i++)
+        {
+            const int32_t delay_integral   = static_cast<int32_t>(delay[i]);
+            const float   delay_fractional
+                = delay[i] - static_cast<float>(delay_integral);
+            const size_t t = wrap(write_ptr_ + delay_integral - i);
+            const T      a = Codec::Decode(line_[t]);
+            const T      b = Codec::Decode(line_[wrap(t + 1)]);
+            out[i]         = a + (b - a) * delay_fractional;
+        }
+    }
+
+    /** ReadHermite() counterpart of ReadBlock(). Needs delay[i] >= i + 2. */
+    inline void ReadHermiteBlock(const float *delay, T *out, size_t size) const
+    {
+        using infrasonic::simd::float4;
+        alignas(16) float xm1[4], x0[4], x1[4], x2[4], f[4];
+        const float4 half = infrasonic::simd::set1(0.5f);
+        size_t i = 0;
+        for(; i + 4 <= size; i += 4)
+        {
+            for(size_t j = 0; j < 4; j++)
+            {
+                const int32_t delay_integral
+                    = static_cast<int32_t>(delay[i + j]);
+                f[j] = delay[i + j] - static_cast<float>(delay_integral);
+                const size_t t0
+                    = wrap(write_ptr_ + delay_integral - (i + j) - 1);
+                const size_t t1 = wrap(t0 + 1);
+                const size_t t2 = wrap(t1 + 1);
+                xm1[j]          = Codec::Decode(line_[t0]);
+                x0[j]           = Codec::Decode(line_[t1]);
+                x1[j]           = Codec::Decode(line_[t2]);
+                x2[j]           = Codec::Decode(line_[wrap(t2 + 1)]);
+            }
+            const float4 vxm1  = infrasonic::simd::load(xm1);
+            const float4 vx0   = infrasonic::simd::load(x0);
+            const float4 vx1   = infrasonic::simd::load(x1);
+            const float4 vx2   = infrasonic::simd::load(x2);
+            const float4 vf    = infrasonic::simd::load(f);
+            const float4 c     = (vx1 - vxm1) * half;
+            const float4 v     = vx0 - vx1;
+            const float4 w     = c + v;
+            const float4 a     = w + v + (vx2 - vx0) * half;
+            const float4 b_neg = w + a;
+            infrasonic::simd::store(out + i,
+                                    (((a * vf) - b_neg) * vf + c) * vf + vx0);
+        }
+        for(; i < size; i++)
+        {
+            // i more writes move every sample i positions closer; the
+            // subtraction is exact for any delay that fits the line
+            out[i] = ReadHermite(delay[i] - static_cast<float>(i));
+        }
+    }
+
+    /** Writes size samples, as that many calls to Write() would */
+    inline void WriteBlock(const T *in, size_t size)
+    {
+        size_t i = 0;
+        // Without a wrap the block lands contiguously, reversed
+        if(write_ptr_ + 1 >= size)
+        {
+            for(; i + 4 <= size; i += 4)
+            {
+                Codec::Encode4(
+                    line_ + write_ptr_ - i - 3,
+                    infrasonic::simd::reverse(infrasonic::simd::load(in + i)));
+            }
+        }
+        write_ptr_ = (write_ptr_ + max_size - i) % max_size;
+        for(; i < size; i++)
+        {
+            line_[write_ptr_] = Codec::Encode(in[i]);
+            write_ptr_ = write_ptr_ > 0 ? write_ptr_ - 1 : max_size - 1;
+        }
+        dirty_ = dirty_ + size < max_size ? dirty_ + size : max_size;
+    }
+
     inline const T Allpass(const T sample, size_t delay, const T coefficient)
     {
-        T read  = line_[(write_ptr_ + delay) % max_size];
+        T read  = Codec::Decode(line_[(write_ptr_ + delay) % max_size]);
         T write = sample + coefficient * read;
         Write(write);
         return -write * coefficient + read;
     }
 
   private:
+    /// Index into the line for positions up to 2 * max_size - 1
+    static inline size_t wrap(size_t i)
+    {
+        return i >= max_size ? i - max_size : i;
+    }
+
     float  frac_;
     size_t write_ptr_;
     size_t delay_;
-    T      line_[max_size];
+    // High-water mark of samples written since the last Reset(), capped at
+    // max_size. Starts full since the buffer is uninitialised.
+    size_t dirty_ = max_size;
+    Stored line_[max_size];
 };
 } // namespace daisysp
 #endif
@@ -1,4 +1,5 @@
 #include "ReverbSc.h"
+#include "../DSPMath.h"
 #include <cstdint>
 #include <math.h>
 
@@ -155,7 +156,9 @@ int ReverbSc::Process(const float &in1,
     {
         prv_lpfreq_ = lpfreq_;
         damp_fact
-            = 2.0f - cosf(prv_lpfreq_ * (2.0f * (float)M_PI) / sample_rate_);
+            = 2.0f
+              - infrasonic::fastmath::cos(prv_lpfreq_ * (2.0f * (float)M_PI)
+                                          / sample_rate_);
         damp_fact = damp_fact_
             = damp_fact - sqrtf(damp_fact * damp_fact - 1.0f);
     }
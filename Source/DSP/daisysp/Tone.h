@@ -24,7 +24,7 @@ class Tone
     void SetFreq(float freq)
     {
         float wc = 2.0f * PI_F * freq / sample_rate_;
-        float c = 2.0f - cosf(wc);
+        float c = 2.0f - infrasonic::fastmath::cos(wc);
         coef_ = c - sqrtf(c * c - 1.0f);
     }
 
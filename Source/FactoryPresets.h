@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include <span>
+#include <string_view>
+
+// Factory bank compiled into the plugin. PresetManager lists it as a
+// read-only bank next to the user presets, so nothing is written to disk.
+// Values are plain (not normalised) parameter values; anything not listed
+// stays at its default.
+struct FactoryValue {
+  int index; // ParamIds
+  float value;
+
+  // An unknown parameter ID is a compile error
+  consteval FactoryValue(std::string_view id, float plainValue)
+      : index(ParamIds::indexOf(id)), value(plainValue) {
+    if (index < 0)
+      throw "Unknown parameter ID in a factory preset";
+  }
+};
+
+struct FactoryPreset {
+  const char *name;
+  std::span<const FactoryValue> values;
+};
+
+namespace FactoryBank {
+// 1. Factory - Lush Pad
+// Slow attack, reverb, chorus-y modulation
+inline constexpr FactoryValue kLushPad[] = {
+    {"freq", 0.2f}, // Low pitch
+    {"verb_mix", 0.6f},
+    {"verb_decay", 0.8f},
+    {"width", 1.5f},
+    {"lfo1_rate", 0.2f},
+    {"lfo1_depth", 0.3f},
+    {"lfo1_target", 1.0f}}; // Freq
+
+// 2. Factory - Rhythmic Gater
+// Gate enabled, LFO on Gate Thresh
+inline constexpr FactoryValue kRhythmicGater[] = {
+    {"gate_enabled", 1.0f},
+    {"gate_thresh", -20.0f},
+    {"lfo1_sync", 1.0f},
+    {"lfo1_div", 10.0f},    // 1/16
+    {"lfo1_shape", 4.0f},   // Square
+    {"lfo1_target", 13.0f}, // Gate Thresh
+    {"lfo1_depth", 0.8f}};
+
+// 3. Factory - Deep Space
+// High feedback, long delay, echo
+inline constexpr FactoryValue kDeepSpace[] = {
+    {"fb_gain", 0.95f},
+    {"fb_delay", 0.5f},
+    {"echo_send", 0.7f},
+    {"echo_time", 1.5f},
+    {"echo_fb", 0.8f},
+    {"verb_mix", 0.8f}};
+
+// 4. Factory - Acid Lead
+// Drive, Saw LFO on Filter
+inline constexpr FactoryValue kAcidLead[] = {
+    {"drive_enabled", 1.0f},
+    {"drive_amount", 0.6f},
+    {"drive_gain", -3.0f},
+    {"fb_lpf", 2000.0f},
+    {"lfo1_rate", 8.0f},
+    {"lfo1_shape", 2.0f},  // Saw
+    {"lfo1_target", 4.0f}, // FB LPF
+    {"lfo1_depth", 0.7f}};
+
+inline constexpr FactoryPreset kPresets[] = {
+    {"Factory - Lush Pad", kLushPad},
+    {"Factory - Rhythmic Gater", kRhythmicGater},
+    {"Factory - Deep Space", kDeepSpace},
+    {"Factory - Acid Lead", kAcidLead},
+};
+} // namespace FactoryBank
+
+inline constexpr std::span<const FactoryPreset> getFactoryPresets() {
+  return FactoryBank::kPresets;
+}
@@ -0,0 +1,199 @@
+#include "LoopAnalyzer.h"
+
+LoopAnalyzer::LoopAnalyzer(DawdreyAudioProcessor &p) : audioProcessor(p) {
+  setOpaque(true);
+
+  spectrumDb.fill(kMinDb);
+  scopePath.preallocateSpace(kScopePoints * 3 + 4);
+  spectrumPath.preallocateSpace(kSpectrumPoints * 3 + 4);
+
+  addAndMakeVisible(sourceButton);
+  sourceButton.setClickingTogglesState(true);
+  sourceButton.setTooltip(
+      "Analyzer Source: plugin output or the signal fed back into the loop");
+  sourceButton.onClick = [this] {
+    const bool tapLoop = sourceButton.getToggleState();
+    sourceButton.setButtonText(tapLoop ? "Loop" : "Out");
+    audioProcessor.analyzerTapsLoop.store(tapLoop);
+    clearHistory();
+  };
+  sourceButton.setToggleState(audioProcessor.analyzerTapsLoop.load(),
+                              juce::dontSendNotification);
+  sourceButton.setButtonText(sourceButton.getToggleState() ? "Loop" : "Out");
+}
+
+LoopAnalyzer::~LoopAnalyzer() {
+  stopTimer();
+  setTapActive(false);
+}
+
+void LoopAnalyzer::paint(juce::Graphics &g) {
+  const auto gold = juce::Colour::fromString("FFD4AF37");
+
+  g.fillAll(juce::Colour::fromString("FF0F0F0F"));
+
+  g.setColour(gold.withAlpha(0.15f));
+  g.drawHorizontalLine((int)scopeArea.getCentreY(), scopeArea.getX(),
+                       scopeArea.getRight());
+  g.drawRect(scopeArea);
+  g.drawRect(spectrumArea);
+
+  g.setColour(gold);
+  g.strokePath(scopePath, juce::PathStrokeType(1.2f));
+  g.strokePath(spectrumPath, juce::PathStrokeType(1.2f));
+}
+
+void LoopAnalyzer::resized() {
+  auto area = getLocalBounds();
+  sourceButton.setBounds(area.removeFromLeft(50).removeFromTop(24));
+  area.removeFromLeft(6);
+
+  auto bounds = area.toFloat();
+  scopeArea = bounds.removeFromLeft(bounds.getWidth() * 0.4f).reduced(2.0f);
+  spectrumArea = bounds.reduced(2.0f);
+
+  updateScopePath();
+  updateSpectrumPath();
+}
+
+void LoopAnalyzer::visibilityChanged() { updateTimerState(); }
+
+void LoopAnalyzer::parentHierarchyChanged() { updateTimerState(); }
+
+void LoopAnalyzer::updateTimerState() {
+  if (isVisible() && getPeer() != nullptr) {
+    startTimerHz(30);
+  } else {
+    stopTimer();
+    setTapActive(false);
+  }
+}
+
+void LoopAnalyzer::setTapActive(bool shouldBeActive) {
+  if (tapActive == shouldBeActive)
+    return;
+
+  tapActive = shouldBeActive;
+  audioProcessor.analyzerActive.store(tapActive);
+
+  // Whatever is still queued is stale by the time we resume
+  if (tapActive)
+    while (audioProcessor.analyzerFifo.pull(pullBuffer.data(),
+                                            (int)pullBuffer.size()) > 0) {
+    }
+}
+
+void LoopAnalyzer::clearHistory() {
+  history.fill(0.0f);
+  spectrumDb.fill(kMinDb);
+  historyPos = 0;
+}
+
+void LoopAnalyzer::timerCallback() {
+  // Covers the editor window being minimised or hidden by the host, which
+  // does not reach visibilityChanged()
+  setTapActive(isShowing());
+  if (!tapActive)
+    return;
+
+  int numNew = 0;
+  for (;;) {
+    const int pulled = audioProcessor.analyzerFifo.pull(
+        pullBuffer.data(), (int)pullBuffer.size());
+    if (pulled == 0)
+      break;
+
+    for (int i = 0; i < pulled; ++i) {
+      history[(size_t)historyPos] = pullBuffer[(size_t)i];
+      historyPos = (historyPos + 1) % kFftSize;
+    }
+    numNew += pulled;
+  }
+
+  if (numNew == 0)
+    return;
+
+  updateScopePath();
+  updateSpectrumPath();
+  repaint();
+}
+
+void LoopAnalyzer::updateScopePath() {
+  // Oldest-first view of the history
+  auto sampleAt = [this](int j) {
+    return history[(size_t)((historyPos + j) % kFftSize)];
+  };
+
+  // Rising zero crossing trigger keeps periodic loops standing still
+  const int latestStart = kFftSize - kScopeLength;
+  int start = latestStart;
+  for (int j = latestStart; j > latestStart - 512 && j > 0; --j) {
+    if (sampleAt(j - 1) < 0.0f && sampleAt(j) >= 0.0f) {
+      start = j;
+      break;
+    }
+  }
+
+  scopePath.clear();
+  const float halfHeight = scopeArea.getHeight() * 0.5f;
+  for (int p = 0; p < kScopePoints; ++p) {
+    const int j = start + p * kScopeLength / kScopePoints;
+    const float y = scopeArea.getCentreY() -
+                    juce::jlimit(-1.0f, 1.0f, sampleAt(j)) * halfHeight;
+    const float x =
+        scopeArea.getX() + scopeArea.getWidth() * (float)p / (kScopePoints - 1);
+    if (p == 0)
+      scopePath.startNewSubPath(x, y);
+    else
+      scopePath.lineTo(x, y);
+  }
+}
+
+void LoopAnalyzer::updateSpectrumPath() {
+  const double sampleRate = audioProcessor.getSampleRate();
+  if (sampleRate <= 0.0)
+    return;
+
+  for (int j = 0; j < kFftSize; ++j)
+    fftData[(size_t)j] = history[(size_t)((historyPos + j) % kFftSize)];
+  std::fill(fftData.begin() + kFftSize, fftData.end(), 0.0f);
+
+  window.multiplyWithWindowingTable(fftData.data(), (size_t)kFftSize);
+  fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+  // Full scale sine -> 0 dB with the Hann window's coherent gain of 0.5
+  const float norm = 4.0f / (float)kFftSize;
+  for (size_t bin = 0; bin < spectrumDb.size(); ++bin) {
+    const float db =
+        juce::Decibels::gainToDecibels(fftData[bin] * norm, kMinDb);
+    spectrumDb[bin] = juce::jmax(db, spectrumDb[bin] - 1.5f);
+  }
+
+  // Log frequency axis, max-decimated to a fixed number of points
+  const float nyquist = (float)sampleRate * 0.5f;
+  const float binsPerHz = (float)kFftSize / (float)sampleRate;
+  const int lastBin = (int)spectrumDb.size() - 1;
+
+  spectrumPath.clear();
+  for (int p = 0; p < kSpectrumPoints; ++p) {
+    const float t0 = (float)p / kSpectrumPoints;
+    const float t1 = (float)(p + 1) / kSpectrumPoints;
+    const float f0 = 20.0f * std::pow(nyquist / 20.0f, t0);
+    const float f1 = 20.0f * std::pow(nyquist / 20.0f, t1);
+    const int b0 = juce::jlimit(1, lastBin, (int)(f0 * binsPerHz));
+    const int b1 = juce::jlimit(b0, lastBin, (int)(f1 * binsPerHz));
+
+    float db = kMinDb;
+    for (int b = b0; b <= b1; ++b)
+      db = juce::jmax(db, spectrumDb[(size_t)b]);
+
+    const float x = spectrumArea.getX() + spectrumArea.getWidth() * t0;
+    const float y =
+        juce::jmap(db, kMinDb, 0.0f, spectrumArea.getBottom(),
+                   spectrumArea.getY());
+    if (p == 0)
+      spectrumPath.startNewSubPath(x, y);
+    else
+      spectrumPath.lineTo(x, y);
+  }
+}
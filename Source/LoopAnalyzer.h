@@ -0,0 +1,61 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include <JuceHeader.h>
+#include <array>
+
+// Oscilloscope and spectrum view of either the plugin output or the signal
+// written back into the feedback loop.
+//
+// Samples arrive through DawdreyAudioProcessor::analyzerFifo. The FFT runs
+// on the message thread with a plan and buffers allocated once up front,
+// and both traces are drawn at a fixed, decimated number of points. The
+// processor is only asked to feed the tap while this component is showing.
+class LoopAnalyzer : public juce::Component, private juce::Timer {
+public:
+  explicit LoopAnalyzer(DawdreyAudioProcessor &p);
+  ~LoopAnalyzer() override;
+
+  void paint(juce::Graphics &) override;
+  void resized() override;
+  void visibilityChanged() override;
+  void parentHierarchyChanged() override;
+
+private:
+  void timerCallback() override;
+  void updateTimerState();
+  void setTapActive(bool shouldBeActive);
+  void clearHistory();
+
+  void updateScopePath();
+  void updateSpectrumPath();
+
+  static constexpr int kFftOrder = 11;
+  static constexpr int kFftSize = 1 << kFftOrder;
+  static constexpr int kScopeLength = 1024;
+  static constexpr int kScopePoints = 256;
+  static constexpr int kSpectrumPoints = 192;
+  static constexpr float kMinDb = -90.0f;
+
+  DawdreyAudioProcessor &audioProcessor;
+
+  juce::dsp::FFT fft{kFftOrder};
+  juce::dsp::WindowingFunction<float> window{
+      (size_t)kFftSize, juce::dsp::WindowingFunction<float>::hann, false};
+
+  // Circular history of the newest kFftSize samples
+  std::array<float, kFftSize> history{};
+  int historyPos = 0;
+
+  std::array<float, 2048> pullBuffer{};
+  std::array<float, kFftSize * 2> fftData{};
+  std::array<float, kFftSize / 2> spectrumDb{};
+
+  juce::Path scopePath, spectrumPath;
+  juce::Rectangle<float> scopeArea, spectrumArea;
+
+  juce::TextButton sourceButton{"Out"};
+  bool tapActive = false;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopAnalyzer)
+};
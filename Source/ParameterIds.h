@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// Parameter IDs in the order createParameterLayout() adds them, so an index
+// here is also the index into AudioProcessor::getParameters(). The strings
+// are what hosts and saved presets refer to and must never change; new
+// parameters go at the end.
+namespace ParamIds {
+enum Index : int {
+  Freq,
+  FbGain,
+  FbDelay,
+  FbLpf,
+  FbHpf,
+  VerbMix,
+  VerbDecay,
+  EchoSend,
+  EchoTime,
+  EchoFb,
+  DryWet,
+  Width,
+  GateEnabled,
+  GateThresh,
+  GateRelease,
+  DriveEnabled,
+  DriveAmount,
+  DriveGain,
+  PitchEnabled,
+  PitchShift,
+  PitchFine,
+  InstrumentMode,
+  Lfo1Rate,
+  Lfo1Depth,
+  Lfo1Shape,
+  Lfo1Target,
+  Lfo1Sync,
+  Lfo1Bipolar,
+  Lfo1Div,
+  Lfo2Rate,
+  Lfo2Depth,
+  Lfo2Shape,
+  Lfo2Target,
+  Lfo2Sync,
+  Lfo2Bipolar,
+  Lfo2Div,
+  Lfo3Rate,
+  Lfo3Depth,
+  Lfo3Shape,
+  Lfo3Target,
+  Lfo3Sync,
+  Lfo3Bipolar,
+  Lfo3Div,
+  FbSlope,
+  EchoTaps,
+  EchoPingPong,
+  Quality,
+  Count
+};
+
+inline constexpr const char *kIds[Count] = {
+    "freq",          "fb_gain",      "fb_delay",      "fb_lpf",
+    "fb_hpf",        "verb_mix",     "verb_decay",    "echo_send",
+    "echo_time",     "echo_fb",      "dry_wet",       "width",
+    "gate_enabled",  "gate_thresh",  "gate_release",  "drive_enabled",
+    "drive_amount",  "drive_gain",   "pitch_enabled", "pitch_shift",
+    "pitch_fine",    "instrument_mode",               "lfo1_rate",
+    "lfo1_depth",    "lfo1_shape",   "lfo1_target",   "lfo1_sync",
+    "lfo1_bipolar",  "lfo1_div",     "lfo2_rate",     "lfo2_depth",
+    "lfo2_shape",    "lfo2_target",  "lfo2_sync",     "lfo2_bipolar",
+    "lfo2_div",      "lfo3_rate",    "lfo3_depth",    "lfo3_shape",
+    "lfo3_target",   "lfo3_sync",    "lfo3_bipolar",  "lfo3_div",
+    "fb_slope",      "echo_taps",    "echo_pingpong", "quality"};
+
+static_assert(kIds[Count - 1] != nullptr, "kIds is missing entries");
+
+// -1 for unknown IDs. Usable in constant expressions.
+constexpr int indexOf(std::string_view id) {
+  for (int i = 0; i < Count; ++i)
+    if (id == kIds[i])
+      return i;
+  return -1;
+}
+
+// FNV-1a of an ID; the key binary states and banks store parameters under
+constexpr uint32_t hash(std::string_view id) {
+  uint32_t h = 2166136261u;
+  for (const char c : id) {
+    h ^= (uint8_t)c;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+inline constexpr auto kHashes = [] {
+  std::array<uint32_t, Count> hashes{};
+  for (int i = 0; i < Count; ++i)
+    hashes[(size_t)i] = hash(kIds[i]);
+  return hashes;
+}();
+
+static_assert(
+    [] {
+      for (int i = 0; i < Count; ++i)
+        for (int j = i + 1; j < Count; ++j)
+          if (kHashes[(size_t)i] == kHashes[(size_t)j])
+            return false;
+      return true;
+    }(),
+    "Two parameter IDs share a hash");
+
+// -1 for unknown hashes
+constexpr int indexOfHash(uint32_t h) {
+  for (int i = 0; i < Count; ++i)
+    if (kHashes[(size_t)i] == h)
+      return i;
+  return -1;
+}
+} // namespace ParamIds
@@ -4,11 +4,39 @@
 DawdreyAudioProcessorEditor::DawdreyAudioProcessorEditor(
     DawdreyAudioProcessor &p)
     : AudioProcessorEditor(&p), audioProcessor(p) {
-  setSize(1300, 800);
+  setOpaque(true);
+  setSize(1300, 970);
   startTimerHz(60);
 
   auto &apvts = audioProcessor.apvts;
 
+  modTargetSliders = {nullptr,
+                      &freqSlider,
+                      &fbGainSlider,
+                      &fbDelaySlider,
+                      &fbLpfSlider,
+                      &fbHpfSlider,
+                      &verbMixSlider,
+                      &verbDecaySlider,
+                      &echoSendSlider,
+                      &echoTimeSlider,
+                      &echoFbSlider,
+                      &dryWetSlider,
+                      &widthSlider,
+                      &gateThreshSlider,
+                      &gateReleaseSlider,
+                      &driveAmountSlider,
+                      &driveGainSlider,
+                      &pitchShiftSlider,
+                      &pitchFineSlider};
+  lastModValues.fill(-1.0f);
+
+  for (int lfo = 0; lfo < 3; ++lfo) {
+    const juce::String prefix = "lfo" + juce::String(lfo + 1) + "_";
+    lfoTargetValues[lfo] = apvts.getRawParameterValue(prefix + "target");
+    lfoDepthValues[lfo] = apvts.getRawParameterValue(prefix + "depth");
+  }
+
   setLookAndFeel(&customLookAndFeel);
 
   addAndMakeVisible(presetBox);
@@ -17,6 +45,7 @@ DawdreyAudioProcessorEditor::DawdreyAudioProcessorEditor(
 
   auto presets = audioProcessor.presetManager->getAllPresets();
   presetBox.addItemList(presets, 1);
+  audioProcessor.presetManager->getLibrary().addChangeListener(this);
 
   presetBox.onChange = [this] {
     if (presetBox.getSelectedId() > 0) {
@@ -79,15 +108,19 @@ DawdreyAudioProcessorEditor::DawdreyAudioProcessorEditor(
 
   importPresetButton.onClick = [this] {
     fileChooser = std::make_unique<juce::FileChooser>(
-        "Import Preset",
-        juce::File::getSpecialLocation(juce::File::userHomeDirectory), "*.xml");
+        "Import Preset or Bank",
+        juce::File::getSpecialLocation(juce::File::userHomeDirectory),
+        "*.xml;*.dwbank");
     auto folderFlags = juce::FileBrowserComponent::openMode |
                        juce::FileBrowserComponent::canSelectFiles;
 
     fileChooser->launchAsync(folderFlags, [this](const juce::FileChooser &fc) {
       auto file = fc.getResult();
       if (file != juce::File{}) {
-        audioProcessor.presetManager->loadPresetFromFile(file);
+        if (file.hasFileExtension(PresetBank::kFileExtension))
+          audioProcessor.presetManager->openBank(file);
+        else
+          audioProcessor.presetManager->loadPresetFromFile(file);
         updatePresetList();
       }
     });
@@ -95,14 +128,20 @@ DawdreyAudioProcessorEditor::DawdreyAudioProcessorEditor(
 
   exportPresetButton.onClick = [this] {
     fileChooser = std::make_unique<juce::FileChooser>(
-        "Export Preset",
-        juce::File::getSpecialLocation(juce::File::userHomeDirectory), "*.xml");
+        "Export Preset (or all presets as a .dwbank)",
+        juce::File::getSpecialLocation(juce::File::userHomeDirectory),
+        "*.xml;*.dwbank");
     auto folderFlags = juce::FileBrowserComponent::saveMode |
                        juce::FileBrowserComponent::canSelectFiles;
 
     fileChooser->launchAsync(folderFlags, [this](const juce::FileChooser &fc) {
       auto file = fc.getResult();
       if (file != juce::File{}) {
+        if (file.hasFileExtension(PresetBank::kFileExtension)) {
+          audioProcessor.presetManager->exportBank(file);
+          return;
+        }
+
         if (!file.hasFileExtension("xml"))
           file = file.withFileExtension("xml");
 
@@ -128,14 +167,52 @@ DawdreyAudioProcessorEditor::DawdreyAudioProcessorEditor(
       new juce::AudioProcessorValueTreeState::ButtonAttachment(
           apvts, "instrument_mode", instrumentModeButton));
 
+  addAndMakeVisible(qualityBox);
+  qualityBox.addItemList(apvts.getParameter("quality")->getAllValueStrings(),
+                         1);
+  qualityBox.setJustificationType(juce::Justification::centred);
+  qualityBox.setTooltip(
+      "Quality: Eco uses the plain loop clipper, Normal anti-aliases it");
+  qualityAttachment =
+      std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+          apvts, "quality", qualityBox);
+
+  addAndMakeVisible(fbSlopeBox);
+  fbSlopeBox.addItemList(apvts.getParameter("fb_slope")->getAllValueStrings(),
+                         1);
+  fbSlopeBox.setJustificationType(juce::Justification::centred);
+  fbSlopeBox.setTooltip(
+      "Feedback Filter Slope: Rolloff of the loop lowpass and highpass");
+  fbSlopeAttachment =
+      std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+          apvts, "fb_slope", fbSlopeBox);
+
+  addAndMakeVisible(echoTapsBox);
+  echoTapsBox.addItemList(apvts.getParameter("echo_taps")->getAllValueStrings(),
+                          1);
+  echoTapsBox.setJustificationType(juce::Justification::centred);
+  echoTapsBox.setTooltip(
+      "Echo Taps: Evenly spaced playback heads up to the echo time");
+  echoTapsAttachment =
+      std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+          apvts, "echo_taps", echoTapsBox);
+
+  addAndMakeVisible(echoPingPongButton);
+  echoPingPongButton.setButtonText("Ping-Pong");
+  echoPingPongButton.setTooltip(
+      "Echo Ping-Pong: Repeats alternate between left and right");
+  echoPingPongAttachment.reset(
+      new juce::AudioProcessorValueTreeState::ButtonAttachment(
+          apvts, "echo_pingpong", echoPingPongButton));
+
   presetBox.setTooltip("Load a preset");
   savePresetButton.setTooltip("Save current settings as a new preset");
   initPresetButton.setTooltip("Reset all parameters to default");
   prevPresetButton.setTooltip("Load previous preset");
   nextPresetButton.setTooltip("Load next preset");
 
-  inputLevelMeter.setTooltip("Input Level (Stereo Peak)");
-  outputLevelMeter.setTooltip("Output Level (Stereo Peak)");
+  inputLevelMeter.setTooltip("Input Level (Stereo Peak / RMS)");
+  outputLevelMeter.setTooltip("Output Level (Stereo Peak / RMS)");
 
   gateEnabledButton.setTooltip("Enable Noise Gate");
   gateThreshSlider.setTooltip(
@@ -409,6 +486,45 @@ DawdreyAudioProcessorEditor::DawdreyAudioProcessorEditor(
   addAndMakeVisible(inputLevelMeter);
   addAndMakeVisible(outputLevelMeter);
 
+  addAndMakeVisible(loopAnalyzer);
+
+  addAndMakeVisible(telemetryLabel);
+  telemetryLabel.setJustificationType(juce::Justification::centredRight);
+  telemetryLabel.setTooltip(
+      "Audio thread load for this instance and feedback loop energy");
+
+  addAndMakeVisible(timingButton);
+  timingButton.setTooltip(
+      "Save block timings and the slowest blocks with their context as JSON");
+  timingButton.onClick = [this] {
+    fileChooser = std::make_unique<juce::FileChooser>(
+        "Save Timing Report",
+        juce::File::getSpecialLocation(juce::File::userHomeDirectory)
+            .getChildFile("dawdrey-timing.json"),
+        "*.json");
+    auto fileFlags = juce::FileBrowserComponent::saveMode |
+                     juce::FileBrowserComponent::canSelectFiles;
+
+    const auto json = juce::JSON::toString(audioProcessor.createTimingReport());
+    fileChooser->launchAsync(fileFlags, [json](const juce::FileChooser &fc) {
+      auto file = fc.getResult();
+      if (file != juce::File{})
+        file.withFileExtension("json").replaceWithText(json);
+    });
+  };
+
+  // Developer panel, only offered in builds with stage timers
+  addChildComponent(profilerPanel);
+#if INFS_PROFILING
+  addAndMakeVisible(profileButton);
+  profileButton.setClickingTogglesState(true);
+  profileButton.setTooltip("Per-stage CPU breakdown of the audio thread");
+  profileButton.onClick = [this] {
+    profilerPanel.setVisible(profileButton.getToggleState());
+    profilerPanel.toFront(false);
+  };
+#endif
+
   addAndMakeVisible(lfo2SyncButton);
   lfo2SyncButton.setButtonText("Sync");
   lfo2SyncAttachment =
@@ -527,11 +643,30 @@ DawdreyAudioProcessorEditor::DawdreyAudioProcessorEditor(
 }
 
 DawdreyAudioProcessorEditor::~DawdreyAudioProcessorEditor() {
+  audioProcessor.presetManager->getLibrary().removeChangeListener(this);
   setSize(1100, 800);
   setLookAndFeel(nullptr);
 }
 
 void DawdreyAudioProcessorEditor::paint(juce::Graphics &g) {
+  // Panels and titles only change with the layout, so they are rendered once
+  // into an image at the current display scale and blitted from then on
+  const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+  if (!backgroundCache.isValid() || scale != backgroundCacheScale) {
+    backgroundCacheScale = scale;
+    backgroundCache =
+        juce::Image(juce::Image::RGB, juce::roundToInt(getWidth() * scale),
+                    juce::roundToInt(getHeight() * scale), false);
+
+    juce::Graphics cacheGraphics(backgroundCache);
+    cacheGraphics.addTransform(juce::AffineTransform::scale(scale));
+    paintBackground(cacheGraphics);
+  }
+
+  g.drawImage(backgroundCache, getLocalBounds().toFloat());
+}
+
+void DawdreyAudioProcessorEditor::paintBackground(juce::Graphics &g) {
   g.fillAll(juce::Colour(0xff1a1a1a));
 
   g.setColour(juce::Colour(0xffd4af37));
@@ -566,6 +701,8 @@ void DawdreyAudioProcessorEditor::paint(juce::Graphics &g) {
 
   auto area = getLocalBounds().reduced(10);
   area.removeFromTop(40);
+  area.removeFromBottom(20); // Status line
+  drawGroup(area.removeFromBottom(150), "LOOP ANALYZER");
 
   // --- MAIN COLUMNS ---
   // 1. Input Meter (Far Left)
@@ -626,6 +763,8 @@ void DawdreyAudioProcessorEditor::resized() {
   int width = getWidth();
   int height = getHeight();
 
+  backgroundCache = juce::Image(); // Re-rendered on next paint
+
   auto area = getLocalBounds().reduced(10);
 
   // Header (Presets)
@@ -638,6 +777,10 @@ void DawdreyAudioProcessorEditor::resized() {
   auto instrumentArea = headerArea.removeFromRight(150);
   instrumentModeButton.setBounds(instrumentArea.reduced(5));
 
+  // Quality Tier (Left of Instrument Mode)
+  auto qualityArea = headerArea.removeFromRight(100);
+  qualityBox.setBounds(qualityArea.reduced(2, 6));
+
   int buttonW = 50;
   int wideButtonW = 60; // Wider for Import/Export/Save
   int comboW = 200;
@@ -668,6 +811,21 @@ void DawdreyAudioProcessorEditor::resized() {
   exportPresetButton.setBounds(
       presetGroupArea.removeFromLeft(wideButtonW).reduced(2));
 
+  // Status line (Bottom)
+  auto statusArea = area.removeFromBottom(20);
+  telemetryLabel.setBounds(statusArea.removeFromRight(260).reduced(0, 1));
+  timingButton.setBounds(statusArea.removeFromLeft(70).reduced(0, 1));
+  profileButton.setBounds(statusArea.removeFromLeft(70).reduced(0, 1));
+  profilerPanel.setTopLeftPosition(statusArea.getRight() -
+                                       profilerPanel.getWidth(),
+                                   statusArea.getY() -
+                                       profilerPanel.getHeight() - 4);
+
+  // Analyzer strip (Above status line)
+  auto analyzerGroup = area.removeFromBottom(150).reduced(10);
+  analyzerGroup.removeFromTop(25); // Skip Title
+  loopAnalyzer.setBounds(analyzerGroup.reduced(8, 4));
+
   // --- MAIN COLUMNS ---
   // Layout: [Input Meter] [Input Controls] [Resonator] [Effects] [LFOs] [Output
   // Meter]
@@ -749,7 +907,9 @@ void DawdreyAudioProcessorEditor::resized() {
 
   // --- Resonator Group ---
   auto resGroup = resGroupArea.reduced(10);
-  resGroup.removeFromTop(40); // Skip Title
+  // Filter slope sits right of the title
+  auto resTitle = resGroup.removeFromTop(40);
+  fbSlopeBox.setBounds(resTitle.removeFromRight(80).reduced(2, 8));
 
   // Row 1: Freq, Gain
   auto resRow1 = resGroup.removeFromTop(resGroup.getHeight() / 3);
@@ -801,7 +961,10 @@ void DawdreyAudioProcessorEditor::resized() {
   // --- ECHO GROUP ---
   auto echoArea = midArea.removeFromTop(midArea.getHeight() / 3);
   auto echoGroup = echoArea.reduced(10);
-  echoGroup.removeFromTop(40); // Skip Title
+  // Taps and ping-pong sit right of the title
+  auto echoTitle = echoGroup.removeFromTop(40);
+  echoTapsBox.setBounds(echoTitle.removeFromRight(60).reduced(2, 8));
+  echoPingPongButton.setBounds(echoTitle.removeFromRight(90).reduced(2, 8));
 
   int echoW = echoGroup.getWidth() / 3;
 
@@ -949,111 +1112,65 @@ void DawdreyAudioProcessorEditor::resized() {
 }
 
 void DawdreyAudioProcessorEditor::timerCallback() {
-  auto getTargetSlider = [&](int targetIndex) -> juce::Slider * {
-    switch (targetIndex) {
-    case 1:
-      return &freqSlider;
-    case 2:
-      return &fbGainSlider;
-    case 3:
-      return &fbDelaySlider;
-    case 4:
-      return &fbLpfSlider;
-    case 5:
-      return &fbHpfSlider;
-    case 6:
-      return &verbMixSlider;
-    case 7:
-      return &verbDecaySlider;
-    case 8:
-      return &echoSendSlider;
-    case 9:
-      return &echoTimeSlider;
-    case 10:
-      return &echoFbSlider;
-    case 11:
-      return &dryWetSlider;
-    case 12:
-      return &widthSlider;
-    case 13:
-      return &gateThreshSlider;
-    case 14:
-      return &gateReleaseSlider;
-    case 15:
-      return &driveAmountSlider;
-    case 16:
-      return &driveGainSlider;
-    case 17:
-      return &pitchShiftSlider;
-    case 18:
-      return &pitchFineSlider;
-    default:
-      return nullptr;
-    }
-  };
+  // --- Drain Telemetry ---
+  // Several audio blocks usually arrive per tick: keep the loudest peaks and
+  // average the rest. LFO values are taken from the newest block.
+  float maxIn = 0.0f, maxOut = 0.0f, rmsIn = 0.0f, rmsOut = 0.0f;
+  float cpuLoadSum = 0.0f, loopEnergySum = 0.0f;
+
+  const int numFrames =
+      audioProcessor.telemetry.drain([&](const TelemetryFrame &frame) {
+        maxIn = juce::jmax(maxIn, frame.inputPeak[0], frame.inputPeak[1]);
+        maxOut = juce::jmax(maxOut, frame.outputPeak[0], frame.outputPeak[1]);
+        rmsIn = juce::jmax(rmsIn, frame.inputRms[0], frame.inputRms[1]);
+        rmsOut = juce::jmax(rmsOut, frame.outputRms[0], frame.outputRms[1]);
+        cpuLoadSum += frame.cpuLoad;
+        loopEnergySum += frame.loopEnergy;
+        std::copy(std::begin(frame.lfo), std::end(frame.lfo), lfoValues);
+      });
 
   // Helper to get modulation multiplier (Normalized)
   // Since we standardized DSP to use +/- 0.5 normalized range for full depth,
   // this is now constant for all parameters!
   const float MOD_SCALE = 0.5f;
 
-  std::map<juce::Slider *, float> modAmounts;
-
-  auto accumulateMod = [&](int lfoIdx) {
-    juce::String prefix = "lfo" + juce::String(lfoIdx) + "_";
-    int targetIdx =
-        (int)audioProcessor.apvts.getRawParameterValue(prefix + "target")
-            ->load();
-
-    if (auto *s = getTargetSlider(targetIdx)) {
-      float depth =
-          audioProcessor.apvts.getRawParameterValue(prefix + "depth")->load();
-      float lfoVal = 0.0f;
-      if (lfoIdx == 1)
-        lfoVal = audioProcessor.lfo1Value.load();
-      else if (lfoIdx == 2)
-        lfoVal = audioProcessor.lfo2Value.load();
-      else if (lfoIdx == 3)
-        lfoVal = audioProcessor.lfo3Value.load();
-
-      modAmounts[s] += lfoVal * depth * MOD_SCALE;
-    }
-  };
+  // Fixed size scratch on the stack: idle ticks must not allocate
+  std::array<float, DawdreyAudioProcessor::TARGET_LAST> modAmounts{};
+  std::array<bool, DawdreyAudioProcessor::TARGET_LAST> modulated{};
 
-  accumulateMod(1);
-  accumulateMod(2);
-  accumulateMod(3);
-  for (auto const &[slider, modAmount] : modAmounts) {
-    float currentNorm = slider->valueToProportionOfLength(slider->getValue());
+  for (int lfo = 0; lfo < 3; ++lfo) {
+    const int targetIdx = (int)lfoTargetValues[lfo]->load();
+    if (targetIdx <= DawdreyAudioProcessor::TARGET_NONE ||
+        targetIdx >= DawdreyAudioProcessor::TARGET_LAST)
+      continue;
 
-    float targetNorm = juce::jlimit(0.0f, 1.0f, currentNorm + modAmount);
-
-    slider->getProperties().set("modValue", targetNorm);
-    slider->repaint();
+    modAmounts[(size_t)targetIdx] +=
+        lfoValues[lfo] * lfoDepthValues[lfo]->load() * MOD_SCALE;
+    modulated[(size_t)targetIdx] = true;
   }
 
-  std::vector<juce::Slider *> allTargets = {
-      &freqSlider,       &fbGainSlider,      &fbDelaySlider,
-      &fbLpfSlider,      &fbHpfSlider,       &verbMixSlider,
-      &verbDecaySlider,  &echoSendSlider,    &echoTimeSlider,
-      &echoFbSlider,     &dryWetSlider,      &widthSlider,
-      &gateThreshSlider, &driveAmountSlider, &gateReleaseSlider,
-      &driveGainSlider,  &pitchShiftSlider,  &pitchFineSlider};
-
-  for (auto *s : allTargets) {
-    if (modAmounts.find(s) == modAmounts.end()) {
-      if (s->getProperties().contains("modValue")) {
-        s->getProperties().remove("modValue");
-        s->repaint();
-      }
+  // Only knobs whose indicator actually moved get invalidated, and only
+  // their rotary area
+  for (size_t t = 1; t < modTargetSliders.size(); ++t) {
+    auto *slider = modTargetSliders[t];
+
+    if (modulated[t]) {
+      float currentNorm = slider->valueToProportionOfLength(slider->getValue());
+      float targetNorm = juce::jlimit(0.0f, 1.0f, currentNorm + modAmounts[t]);
+
+      if (std::abs(targetNorm - lastModValues[t]) < 0.001f)
+        continue;
+
+      lastModValues[t] = targetNorm;
+      slider->getProperties().set(daisysp_gui::modValueId(), targetNorm);
+      repaintKnob(*slider);
+    } else if (lastModValues[t] >= 0.0f) {
+      lastModValues[t] = -1.0f;
+      slider->getProperties().remove(daisysp_gui::modValueId());
+      repaintKnob(*slider);
     }
   }
 
-  // --- Update Meters ---
-  // Simple decay for smooth visualization
-  static float inputLevel = 0.0f;
-  static float outputLevel = 0.0f;
-
   bool isInstrumentMode = instrumentModeButton.getToggleState();
 
   freqSlider.setEnabled(!isInstrumentMode);
@@ -1085,20 +1202,50 @@ void DawdreyAudioProcessorEditor::timerCallback() {
 
   wasInstrumentMode = isInstrumentMode;
 
-  float inL = audioProcessor.inputLevelL.load();
-  float inR = audioProcessor.inputLevelR.load();
-  float outL = audioProcessor.outputLevelL.load();
-  float outR = audioProcessor.outputLevelR.load();
+  // --- Update Meters ---
+  // Simple decay for smooth visualization
+  inputMeterPeak = std::max(maxIn, inputMeterPeak - 0.05f);
+  outputMeterPeak = std::max(maxOut, outputMeterPeak - 0.05f);
+  inputMeterRms = std::max(rmsIn, inputMeterRms - 0.05f);
+  outputMeterRms = std::max(rmsOut, outputMeterRms - 0.05f);
+
+  inputLevelMeter.setLevels(inputMeterPeak, inputMeterRms);
+  outputLevelMeter.setLevels(outputMeterPeak, outputMeterRms);
+
+  // --- Status Line ---
+  if (numFrames > 0) {
+    const float coef = 0.1f;
+    smoothedCpuLoad += coef * (cpuLoadSum / (float)numFrames - smoothedCpuLoad);
+    smoothedLoopEnergy +=
+        coef * (loopEnergySum / (float)numFrames - smoothedLoopEnergy);
+  }
 
-  float maxIn = std::max(inL, inR);
-  float maxOut = std::max(outL, outR);
+  if (++statusTick >= 15) { // ~4 Hz, text layout is comparatively expensive
+    statusTick = 0;
+    const float loopDb =
+        juce::Decibels::gainToDecibels(std::sqrt(smoothedLoopEnergy), -100.0f);
+
+    // Only rebuild the text when the displayed digits change
+    const int cpuTenths = juce::roundToInt(smoothedCpuLoad * 1000.0f);
+    const int loopTenths = juce::roundToInt(loopDb * 10.0f);
+    if (cpuTenths != lastCpuTenths || loopTenths != lastLoopTenths) {
+      lastCpuTenths = cpuTenths;
+      lastLoopTenths = loopTenths;
+      telemetryLabel.setText(
+          "CPU " + juce::String(smoothedCpuLoad * 100.0f, 1) + "%   Loop " +
+              juce::String(loopDb, 1) + " dB",
+          juce::dontSendNotification);
+    }
+  }
+}
 
-  // Smooth decay
-  inputLevel = std::max(maxIn, inputLevel - 0.05f);
-  outputLevel = std::max(maxOut, outputLevel - 0.05f);
+void DawdreyAudioProcessorEditor::repaintKnob(juce::Slider &slider) {
+  slider.repaint(slider.getLookAndFeel().getSliderLayout(slider).sliderBounds);
+}
 
-  inputLevelMeter.setLevel(inputLevel);
-  outputLevelMeter.setLevel(outputLevel);
+void DawdreyAudioProcessorEditor::changeListenerCallback(
+    juce::ChangeBroadcaster *) {
+  updatePresetList();
 }
 
 void DawdreyAudioProcessorEditor::updatePresetList() {
@@ -1,13 +1,22 @@
 #pragma once
 
+#include "LoopAnalyzer.h"
 #include "PluginProcessor.h"
+#include "ProfilerPanel.h"
 #include "StyleSheet.h"
 #include <JuceHeader.h>
+#include <array>
 
 class SimpleMeter : public juce::Component, public juce::SettableTooltipClient {
 public:
-  void setLevel(float newLevel) {
-    level = newLevel;
+  void setLevel(float newLevel) { setLevels(newLevel, 0.0f); }
+
+  void setLevels(float newPeak, float newRms) {
+    if (std::abs(newPeak - level) < 0.001f && std::abs(newRms - rms) < 0.001f)
+      return;
+
+    level = newPeak;
+    rms = newRms;
     repaint();
   }
 
@@ -17,6 +26,7 @@ public:
 
 private:
   float level = 0.0f;
+  float rms = 0.0f;
 
   void drawBar(juce::Graphics &g, juce::Rectangle<float> bounds, float level) {
     float cornerRadius = 5.0f;
@@ -47,6 +57,12 @@ private:
 
     g.reduceClipRegion(backgroundPath);
     g.fillRect(fillBounds);
+
+    // RMS body on top of the peak bar
+    auto rmsBounds = bounds.withTrimmedTop(
+        bounds.getHeight() * (1.0f - juce::jlimit(0.0f, 1.0f, rms)));
+    g.setColour(juce::Colours::white.withAlpha(0.25f));
+    g.fillRect(rmsBounds);
     g.restoreState();
 
     g.setColour(juce::Colours::grey.withAlpha(0.5f));
@@ -55,7 +71,8 @@ private:
 };
 
 class DawdreyAudioProcessorEditor : public juce::AudioProcessorEditor,
-                                    public juce::Timer {
+                                    public juce::Timer,
+                                    private juce::ChangeListener {
 public:
   DawdreyAudioProcessorEditor(DawdreyAudioProcessor &);
   ~DawdreyAudioProcessorEditor() override;
@@ -68,6 +85,12 @@ public:
   void updatePresetList();
 
 private:
+  // Preset folder changed
+  void changeListenerCallback(juce::ChangeBroadcaster *) override;
+
+  void paintBackground(juce::Graphics &);
+  void repaintKnob(juce::Slider &);
+
   DawdreyAudioProcessor &audioProcessor;
   daisysp_gui::CustomLookAndFeel customLookAndFeel;
 
@@ -148,6 +171,21 @@ private:
       instrumentModeAttachment;
   bool wasInstrumentMode = false;
 
+  juce::ComboBox qualityBox;
+  std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>
+      qualityAttachment;
+
+  juce::ComboBox fbSlopeBox;
+  std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>
+      fbSlopeAttachment;
+
+  juce::ComboBox echoTapsBox;
+  std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>
+      echoTapsAttachment;
+  juce::ToggleButton echoPingPongButton;
+  std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment>
+      echoPingPongAttachment;
+
   juce::TooltipWindow tooltipWindow{this, 700};
 
   std::unique_ptr<SliderAttachment> lfo1RateAttachment, lfo1DepthAttachment,
@@ -187,6 +225,32 @@ private:
 
   SimpleMeter outputLevelMeter;
 
+  juce::Image backgroundCache;
+  float backgroundCacheScale = 0.0f;
+
+  // Knob per ModulationTarget (index 0 = none) and its last drawn
+  // modulation position (-1 = no indicator)
+  std::array<juce::Slider *, DawdreyAudioProcessor::TARGET_LAST>
+      modTargetSliders{};
+  std::array<float, DawdreyAudioProcessor::TARGET_LAST> lastModValues{};
+  std::atomic<float> *lfoTargetValues[3] = {};
+  std::atomic<float> *lfoDepthValues[3] = {};
+
+  // Telemetry consumer state, per editor instance
+  float lfoValues[3] = {0.0f, 0.0f, 0.0f};
+  float inputMeterPeak = 0.0f, inputMeterRms = 0.0f;
+  float outputMeterPeak = 0.0f, outputMeterRms = 0.0f;
+  float smoothedCpuLoad = 0.0f, smoothedLoopEnergy = 0.0f;
+  int statusTick = 0;
+  int lastCpuTenths = -1, lastLoopTenths = 0;
+  juce::Label telemetryLabel;
+
+  LoopAnalyzer loopAnalyzer{audioProcessor};
+
+  juce::TextButton timingButton{"Timing"};
+  juce::TextButton profileButton{"Profile"};
+  ProfilerPanel profilerPanel{audioProcessor};
+
   juce::Label lfo1RateLabel, lfo1DepthLabel, lfo1ShapeLabel, lfo1TargetLabel;
   juce::Label lfo2RateLabel, lfo2DepthLabel, lfo2ShapeLabel, lfo2TargetLabel;
   juce::Label lfo3RateLabel, lfo3DepthLabel, lfo3ShapeLabel, lfo3TargetLabel;
@@ -1,5 +1,18 @@
 #include "PluginProcessor.h"
+#ifndef DAWDREY_HEADLESS
 #include "PluginEditor.h"
+#endif
+#include <bit>
+
+namespace {
+// Host state: "DWST", uint16 schema version, uint16 entry count, then per
+// entry a uint32 ParamIds::hash and the float plain value, little-endian.
+// Much cheaper than XML for sessions with many instances.
+constexpr juce::uint32 kStateMagic = 0x54535744; // "DWST"
+constexpr juce::uint16 kStateVersion = 1;
+constexpr int kStateHeaderSize = 8;
+constexpr int kStateEntrySize = 8;
+} // namespace
 
 DawdreyAudioProcessor::DawdreyAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -10,55 +23,20 @@ DawdreyAudioProcessor::DawdreyAudioProcessor()
       apvts(*this, &undoManager, "Parameters", createParameterLayout())
 #endif
 {
-  presetManager = std::make_unique<PresetManager>(apvts);
-  freqParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("freq"));
-  fbGainParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("fb_gain"));
-  fbDelayParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("fb_delay"));
-  fbLpfParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("fb_lpf"));
-  fbHpfParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("fb_hpf"));
-  verbMixParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("verb_mix"));
-  verbDecayParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("verb_decay"));
-  echoSendParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("echo_send"));
-  echoTimeParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("echo_time"));
-  echoFbParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("echo_fb"));
-  dryWetParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("dry_wet"));
-  widthParam =
-      dynamic_cast<juce::AudioParameterFloat *>(apvts.getParameter("width"));
-
-  gateEnabledParam = dynamic_cast<juce::AudioParameterBool *>(
-      apvts.getParameter("gate_enabled"));
-  gateThreshParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("gate_thresh"));
-  gateReleaseParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("gate_release"));
-
-  driveEnabledParam = dynamic_cast<juce::AudioParameterBool *>(
-      apvts.getParameter("drive_enabled"));
-  driveAmountParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("drive_amount"));
-  driveGainParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("drive_gain"));
-
-  pitchEnabledParam = dynamic_cast<juce::AudioParameterBool *>(
-      apvts.getParameter("pitch_enabled"));
-  pitchShiftParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("pitch_shift"));
-  pitchFineParam = dynamic_cast<juce::AudioParameterFloat *>(
-      apvts.getParameter("pitch_fine"));
-
-  instrumentModeParam = dynamic_cast<juce::AudioParameterBool *>(
-      apvts.getParameter("instrument_mode"));
+  presetManager = std::make_unique<PresetManager>(apvts, &presetSwitcher);
+  // The layout adds parameters in ParamIds order
+  const auto &allParameters = getParameters();
+  jassert(allParameters.size() == ParamIds::Count);
+  for (int i = 0; i < ParamIds::Count; ++i) {
+    parameters[(size_t)i] =
+        static_cast<juce::RangedAudioParameter *>(allParameters[i]);
+    jassert(parameters[(size_t)i]->getParameterID() == ParamIds::kIds[i]);
+    rawParams[(size_t)i] = apvts.getRawParameterValue(ParamIds::kIds[i]);
+    presetSwitcher.setDiscrete(i, parameters[(size_t)i]->isDiscrete());
+  }
+
+  blockTimes.setParameters(getParameters());
+  presetManager->onPresetLoaded = [this] { blockTimes.notePresetLoad(); };
 }
 
 DawdreyAudioProcessor::~DawdreyAudioProcessor() {}
@@ -229,6 +207,18 @@ DawdreyAudioProcessor::createParameterLayout() {
                         "1/64"},
       8));
 
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "fb_slope", "Feedback Filter Slope",
+      juce::StringArray{"12 dB", "24 dB", "36 dB"}, 0));
+
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "echo_taps", "Echo Taps", juce::StringArray{"1", "2", "3", "4"}, 0));
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "echo_pingpong", "Echo Ping-Pong", false));
+
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "quality", "Quality", juce::StringArray{"Eco", "Normal"}, 1));
+
   return layout;
 }
 
@@ -279,10 +269,22 @@ void DawdreyAudioProcessor::changeProgramName(int index,
 
 void DawdreyAudioProcessor::prepareToPlay(double sampleRate,
                                           int samplesPerBlock) {
-  engine.Init(static_cast<float>(sampleRate));
+  if (engine == nullptr) {
+    engine = std::make_unique<infrasonic::FeedbackSynth::Engine>();
+    engine->SetProfiler(&profiler);
+  }
+
+  engine->Init(static_cast<float>(sampleRate));
   lfo1.Init(static_cast<float>(sampleRate));
   lfo2.Init(static_cast<float>(sampleRate));
   lfo3.Init(static_cast<float>(sampleRate));
+
+  analyzerTapBuffer.assign((size_t)juce::jmax(1, samplesPerBlock), 0.0f);
+  ParameterSnapshot live;
+  for (size_t i = 0; i < rawParams.size(); ++i)
+    live[i] = rawParams[i]->load();
+  presetSwitcher.prepare(sampleRate, live);
+  blockTimes.notePrepare();
 }
 
 void DawdreyAudioProcessor::releaseResources() {
@@ -319,12 +321,33 @@ bool DawdreyAudioProcessor::isBusesLayoutSupported(
 void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                          juce::MidiBuffer &midiMessages) {
   juce::ScopedNoDenormals noDenormals;
+  // Hosts prepare before processing; anything else gets silence
+  if (engine == nullptr) {
+    buffer.clear();
+    return;
+  }
+
+  const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+  INFS_PROFILE_MARK(profileBlockStart);
+  TelemetryFrame frame;
+  blockTimes.beginBlock();
+
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
 
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
 
+  INFS_PROFILE_MARK(profileModulationStart);
+
+  // Live values first, then the switcher decides whether this block plays
+  // them or a staged preset
+  ParameterSnapshot live;
+  for (size_t i = 0; i < rawParams.size(); ++i)
+    live[i] = rawParams[i]->load();
+
+  const auto &p = presetSwitcher.beginBlock(live, buffer.getNumSamples());
+
   // Helper to get BPM
   float bpm = 120.0f;
   if (auto *ph = getPlayHead()) {
@@ -368,35 +391,29 @@ void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     }
   };
 
-  bool lfo1Sync = (bool)apvts.getRawParameterValue("lfo1_sync")->load();
-  float lfo1Rate =
-      lfo1Sync
-          ? getSyncedFreq((int)apvts.getRawParameterValue("lfo1_div")->load())
-          : apvts.getRawParameterValue("lfo1_rate")->load();
+  bool lfo1Sync = (bool)p[ParamIds::Lfo1Sync];
+  float lfo1Rate = lfo1Sync ? getSyncedFreq((int)p[ParamIds::Lfo1Div])
+                            : p[ParamIds::Lfo1Rate];
   lfo1.SetRate(lfo1Rate);
-  lfo1.SetAmp(apvts.getRawParameterValue("lfo1_depth")->load());
-  lfo1.SetWaveform((int)apvts.getRawParameterValue("lfo1_shape")->load());
-  int lfo1Target = (int)apvts.getRawParameterValue("lfo1_target")->load();
-
-  bool lfo2Sync = (bool)apvts.getRawParameterValue("lfo2_sync")->load();
-  float lfo2Rate =
-      lfo2Sync
-          ? getSyncedFreq((int)apvts.getRawParameterValue("lfo2_div")->load())
-          : apvts.getRawParameterValue("lfo2_rate")->load();
+  lfo1.SetAmp(p[ParamIds::Lfo1Depth]);
+  lfo1.SetWaveform((int)p[ParamIds::Lfo1Shape]);
+  int lfo1Target = (int)p[ParamIds::Lfo1Target];
+
+  bool lfo2Sync = (bool)p[ParamIds::Lfo2Sync];
+  float lfo2Rate = lfo2Sync ? getSyncedFreq((int)p[ParamIds::Lfo2Div])
+                            : p[ParamIds::Lfo2Rate];
   lfo2.SetRate(lfo2Rate);
-  lfo2.SetAmp(apvts.getRawParameterValue("lfo2_depth")->load());
-  lfo2.SetWaveform((int)apvts.getRawParameterValue("lfo2_shape")->load());
-  int lfo2Target = (int)apvts.getRawParameterValue("lfo2_target")->load();
-
-  bool lfo3Sync = (bool)apvts.getRawParameterValue("lfo3_sync")->load();
-  float lfo3Rate =
-      lfo3Sync
-          ? getSyncedFreq((int)apvts.getRawParameterValue("lfo3_div")->load())
-          : apvts.getRawParameterValue("lfo3_rate")->load();
+  lfo2.SetAmp(p[ParamIds::Lfo2Depth]);
+  lfo2.SetWaveform((int)p[ParamIds::Lfo2Shape]);
+  int lfo2Target = (int)p[ParamIds::Lfo2Target];
+
+  bool lfo3Sync = (bool)p[ParamIds::Lfo3Sync];
+  float lfo3Rate = lfo3Sync ? getSyncedFreq((int)p[ParamIds::Lfo3Div])
+                            : p[ParamIds::Lfo3Rate];
   lfo3.SetRate(lfo3Rate);
-  lfo3.SetAmp(apvts.getRawParameterValue("lfo3_depth")->load());
-  lfo3.SetWaveform((int)apvts.getRawParameterValue("lfo3_shape")->load());
-  int lfo3Target = (int)apvts.getRawParameterValue("lfo3_target")->load();
+  lfo3.SetAmp(p[ParamIds::Lfo3Depth]);
+  lfo3.SetWaveform((int)p[ParamIds::Lfo3Shape]);
+  int lfo3Target = (int)p[ParamIds::Lfo3Target];
 
   float lfo1Val = 0.0f;
   float lfo2Val = 0.0f;
@@ -408,9 +425,9 @@ void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     lfo3Val = lfo3.Process();
   }
 
-  bool lfo1Bipolar = *apvts.getRawParameterValue("lfo1_bipolar") > 0.5f;
-  bool lfo2Bipolar = *apvts.getRawParameterValue("lfo2_bipolar") > 0.5f;
-  bool lfo3Bipolar = *apvts.getRawParameterValue("lfo3_bipolar") > 0.5f;
+  bool lfo1Bipolar = p[ParamIds::Lfo1Bipolar] > 0.5f;
+  bool lfo2Bipolar = p[ParamIds::Lfo2Bipolar] > 0.5f;
+  bool lfo3Bipolar = p[ParamIds::Lfo3Bipolar] > 0.5f;
 
   if (!lfo1Bipolar)
     lfo1Val = (lfo1Val + 1.0f) * 0.5f;
@@ -419,64 +436,62 @@ void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
   if (!lfo3Bipolar)
     lfo3Val = (lfo3Val + 1.0f) * 0.5f;
 
-  lfo1Value.store(lfo1Val);
-  lfo2Value.store(lfo2Val);
-  lfo3Value.store(lfo3Val);
+  frame.lfo[0] = lfo1Val;
+  frame.lfo[1] = lfo2Val;
+  frame.lfo[2] = lfo3Val;
 
   // --- Apply Modulation (Normalized "Knob Sweep") ---
 
   // Helper to calculate modulated value for a parameter
-  auto getModulatedValue = [&](juce::AudioParameterFloat *param,
-                               int targetEnum) -> float {
-    if (!param)
-      return 0.0f;
-
-    float currentNorm =
-        param->getNormalisableRange().convertTo0to1(param->get()); // 0.0 to 1.0
+  auto getModulatedValue = [&](int index, int targetEnum) -> float {
+    const auto &range = parameters[(size_t)index]->getNormalisableRange();
+    float currentNorm = range.convertTo0to1(p[(size_t)index]); // 0.0 to 1.0
     float totalMod = 0.0f;
 
     // Sum modulation from all LFOs targeting this parameter
     // We assume 100% Depth = +/- 50% of the knob range
     if (lfo1Target == targetEnum)
-      totalMod +=
-          lfo1Val * apvts.getRawParameterValue("lfo1_depth")->load() * 0.5f;
+      totalMod += lfo1Val * p[ParamIds::Lfo1Depth] * 0.5f;
     if (lfo2Target == targetEnum)
-      totalMod +=
-          lfo2Val * apvts.getRawParameterValue("lfo2_depth")->load() * 0.5f;
+      totalMod += lfo2Val * p[ParamIds::Lfo2Depth] * 0.5f;
     if (lfo3Target == targetEnum)
-      totalMod +=
-          lfo3Val * apvts.getRawParameterValue("lfo3_depth")->load() * 0.5f;
+      totalMod += lfo3Val * p[ParamIds::Lfo3Depth] * 0.5f;
 
     float newNorm = juce::jlimit(0.0f, 1.0f, currentNorm + totalMod);
-    return param->getNormalisableRange().convertFrom0to1(newNorm);
+    return range.convertFrom0to1(newNorm);
   };
 
-  float freq = getModulatedValue(freqParam, TARGET_FREQ);
-  float fbGain = getModulatedValue(fbGainParam, TARGET_FB_GAIN);
-  float fbDelay = getModulatedValue(fbDelayParam, TARGET_FB_DELAY);
-  float fbLpf = getModulatedValue(fbLpfParam, TARGET_FB_LPF);
-  float fbHpf = getModulatedValue(fbHpfParam, TARGET_FB_HPF);
-  float verbMix = getModulatedValue(verbMixParam, TARGET_VERB_MIX);
-  float verbDecay = getModulatedValue(verbDecayParam, TARGET_VERB_DECAY);
-  float echoSend = getModulatedValue(echoSendParam, TARGET_ECHO_SEND);
-  float echoTime = getModulatedValue(echoTimeParam, TARGET_ECHO_TIME);
-  float echoFb = getModulatedValue(echoFbParam, TARGET_ECHO_FB);
-  float dryWet = getModulatedValue(dryWetParam, TARGET_DRY_WET);
-  float width = getModulatedValue(widthParam, TARGET_WIDTH);
-
-  float gateThresh = getModulatedValue(gateThreshParam, TARGET_GATE_THRESH);
-  float driveAmt = getModulatedValue(driveAmountParam, TARGET_DRIVE_AMT);
-  float gateRelease = getModulatedValue(gateReleaseParam, TARGET_GATE_RELEASE);
-  float driveGain = getModulatedValue(driveGainParam, TARGET_DRIVE_GAIN);
-
-  float pitchShift = getModulatedValue(pitchShiftParam, TARGET_PITCH_SHIFT);
-  float pitchFine = getModulatedValue(pitchFineParam, TARGET_PITCH_FINE);
-
-  inputLevelL = buffer.getMagnitude(0, 0, buffer.getNumSamples());
-  if (totalNumInputChannels > 1)
-    inputLevelR = buffer.getMagnitude(1, 0, buffer.getNumSamples());
-  else
-    inputLevelR = inputLevelL.load();
+  float freq = getModulatedValue(ParamIds::Freq, TARGET_FREQ);
+  float fbGain = getModulatedValue(ParamIds::FbGain, TARGET_FB_GAIN);
+  float fbDelay = getModulatedValue(ParamIds::FbDelay, TARGET_FB_DELAY);
+  float fbLpf = getModulatedValue(ParamIds::FbLpf, TARGET_FB_LPF);
+  float fbHpf = getModulatedValue(ParamIds::FbHpf, TARGET_FB_HPF);
+  float verbMix = getModulatedValue(ParamIds::VerbMix, TARGET_VERB_MIX);
+  float verbDecay = getModulatedValue(ParamIds::VerbDecay, TARGET_VERB_DECAY);
+  float echoSend = getModulatedValue(ParamIds::EchoSend, TARGET_ECHO_SEND);
+  float echoTime = getModulatedValue(ParamIds::EchoTime, TARGET_ECHO_TIME);
+  float echoFb = getModulatedValue(ParamIds::EchoFb, TARGET_ECHO_FB);
+  float dryWet = getModulatedValue(ParamIds::DryWet, TARGET_DRY_WET);
+  float width = getModulatedValue(ParamIds::Width, TARGET_WIDTH);
+
+  float gateThresh = getModulatedValue(ParamIds::GateThresh,
+                                       TARGET_GATE_THRESH);
+  float driveAmt = getModulatedValue(ParamIds::DriveAmount, TARGET_DRIVE_AMT);
+  float gateRelease = getModulatedValue(ParamIds::GateRelease,
+                                        TARGET_GATE_RELEASE);
+  float driveGain = getModulatedValue(ParamIds::DriveGain, TARGET_DRIVE_GAIN);
+
+  float pitchShift = getModulatedValue(ParamIds::PitchShift,
+                                       TARGET_PITCH_SHIFT);
+  float pitchFine = getModulatedValue(ParamIds::PitchFine, TARGET_PITCH_FINE);
+
+  for (int ch = 0; ch < 2; ++ch) {
+    const int srcCh = juce::jmin(ch, totalNumInputChannels - 1);
+    if (srcCh < 0)
+      break;
+    frame.inputPeak[ch] = buffer.getMagnitude(srcCh, 0, buffer.getNumSamples());
+    frame.inputRms[ch] = buffer.getRMSLevel(srcCh, 0, buffer.getNumSamples());
+  }
 
   for (const auto metadata : midiMessages) {
     auto message = metadata.getMessage();
@@ -488,29 +503,41 @@ void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
   }
 
   // --- Synth Processing ---
-  engine.SetStringPitch(freq);
-  engine.SetFeedbackGain(fbGain);
+  engine->SetStringPitch(freq);
+  engine->SetFeedbackGain(fbGain);
 
-  engine.instrumentMode = instrumentModeParam->get();
+  engine->instrumentMode = p[ParamIds::InstrumentMode] > 0.5f;
 
   // Apply Frequency Modulation to MIDI Pitch in Instrument Mode
   // Calculate the modulation amount (delta) from the freq parameter
-  float freqModDelta = freq - freqParam->get();
-  engine.SetMidiPitch((float)lastMidiNote.load() + freqModDelta);
-
-  engine.SetFeedbackDelay(fbDelay);
-  engine.SetFeedbackLPFCutoff(fbLpf);
-  engine.SetFeedbackHPFCutoff(fbHpf);
-  engine.SetReverbMix(verbMix);
-  engine.SetReverbFeedback(verbDecay);
-  engine.SetEchoDelaySendAmount(echoSend);
-  engine.SetEchoDelayTime(echoTime);
-  engine.SetEchoDelayFeedback(echoFb);
-  engine.SetOutputLevel(1.0f); // Engine output is full wet level
-
-  engine.pitchEnabled = *pitchEnabledParam;
-  engine.pitchShift = pitchShift;
-  engine.pitchFine = pitchFine;
+  float freqModDelta = freq - p[ParamIds::Freq];
+  engine->SetMidiPitch((float)lastMidiNote.load() + freqModDelta);
+
+  engine->SetFeedbackDelay(fbDelay);
+  engine->SetFeedbackLPFCutoff(fbLpf);
+  engine->SetFeedbackHPFCutoff(fbHpf);
+  engine->SetFeedbackFilterSlope(static_cast<infrasonic::LowHighFilter::Slope>(
+      (int)p[ParamIds::FbSlope]));
+  engine->SetReverbMix(verbMix);
+  engine->SetReverbFeedback(verbDecay);
+  engine->SetEchoDelaySendAmount(echoSend);
+  engine->SetEchoDelayTime(echoTime);
+  engine->SetEchoDelayFeedback(echoFb);
+  engine->SetEchoDelayTaps((size_t)p[ParamIds::EchoTaps] + 1);
+  engine->SetEchoDelayPingPong(p[ParamIds::EchoPingPong] > 0.5f);
+  engine->SetOutputLevel(1.0f); // Engine output is full wet level
+  engine->SetQuality(static_cast<infrasonic::FeedbackSynth::Engine::Quality>(
+      (int)p[ParamIds::Quality]));
+
+  engine->pitchEnabled = p[ParamIds::PitchEnabled] > 0.5f;
+  engine->pitchShift = pitchShift;
+  engine->pitchFine = pitchFine;
+
+  const bool gateEnabled = p[ParamIds::GateEnabled] > 0.5f;
+  const bool driveEnabled = p[ParamIds::DriveEnabled] > 0.5f;
+
+  INFS_PROFILE_SINCE(&profiler, infrasonic::StageProfiler::BlockModulation,
+                     profileModulationStart);
 
   // Process Audio
   auto *leftIn = buffer.getReadPointer(0);
@@ -521,12 +548,34 @@ void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
       (totalNumOutputChannels > 1) ? buffer.getWritePointer(1) : leftOut;
 
   // Store dry signal for later dry/wet mix
+  INFS_PROFILE_MARK(profileDryCopyStart);
   juce::AudioBuffer<float> dryBuffer(totalNumOutputChannels,
                                      buffer.getNumSamples());
   for (int channel = 0; channel < totalNumOutputChannels; ++channel)
     dryBuffer.copyFrom(channel, 0, buffer, channel, 0, buffer.getNumSamples());
-
-  for (int i = 0; i < buffer.getNumSamples(); ++i) {
+  INFS_PROFILE_SINCE(&profiler, infrasonic::StageProfiler::BlockDryWet,
+                     profileDryCopyStart);
+
+  const bool tapActive = analyzerActive.load(std::memory_order_relaxed);
+  const bool tapLoop =
+      tapActive && analyzerTapsLoop.load(std::memory_order_relaxed);
+  const int tapSamples =
+      juce::jmin(buffer.getNumSamples(), (int)analyzerTapBuffer.size());
+
+  // Gate and drive coefficients only change per block
+  namespace fastmath = infrasonic::fastmath;
+  const float gateThreshLinear =
+      gateThresh > -100.0f ? fastmath::db2lin(gateThresh) : 0.0f;
+  const float gateReleaseCoeff =
+      fastmath::exp(-1.0f / (gateRelease * 0.001f * (float)getSampleRate()));
+  const float driveFactor = 1.0f + (driveAmt * 19.0f);
+  const float driveOutGain = fastmath::db2lin(driveGain);
+
+  // The engine input is built in place in the left channel (the dry signal
+  // is already copied), then the engine renders the whole block over it
+  const int numSamples = buffer.getNumSamples();
+  INFS_PROFILE_MARK(profileGateDriveStart);
+  for (int i = 0; i < numSamples; ++i) {
     float dryL = leftIn[i];
     float dryR = (totalNumInputChannels > 1) ? rightIn[i] : dryL;
 
@@ -535,41 +584,43 @@ void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     // --- Input Processing (Gate & Drive) ---
 
     // 1. Noise Gate
-    if (gateEnabledParam->get()) {
+    if (gateEnabled) {
       float inputLevel = std::abs(in);
-      float threshLinear = juce::Decibels::decibelsToGain(gateThresh);
-      float targetGain = (inputLevel >= threshLinear) ? 1.0f : 0.0f;
-
-      float releaseMs = gateRelease;
-      float releaseCoeff =
-          std::exp(-1.0f / (releaseMs * 0.001f * getSampleRate()));
+      float targetGain = (inputLevel >= gateThreshLinear) ? 1.0f : 0.0f;
 
       if (targetGain > gateCurrentGain)
         gateCurrentGain = targetGain;
       else
         gateCurrentGain =
-            targetGain + releaseCoeff * (gateCurrentGain - targetGain);
+            targetGain + gateReleaseCoeff * (gateCurrentGain - targetGain);
 
       in *= gateCurrentGain;
     }
 
     // 2. Drive (Tanh Saturation)
-    if (driveEnabledParam->get()) {
-      float driveFactor = 1.0f + (driveAmt * 19.0f);
-      in = std::tanh(in * driveFactor);
-
-      float outGain = juce::Decibels::decibelsToGain(driveGain);
-      in *= outGain;
+    if (driveEnabled) {
+      in = fastmath::tanh(in * driveFactor) * driveOutGain;
     }
 
-    float wetL, wetR;
-    engine.Process(in, wetL, wetR);
-
-    leftOut[i] = wetL;
-    if (totalNumOutputChannels > 1)
-      rightOut[i] = wetR;
+    leftOut[i] = in;
+  }
+  INFS_PROFILE_SINCE(&profiler, infrasonic::StageProfiler::BlockGateDrive,
+                     profileGateDriveStart);
+
+  {
+    INFS_PROFILE_SCOPE(&profiler, infrasonic::StageProfiler::BlockEngine);
+    float *wetRight = (totalNumOutputChannels > 1) ? rightOut : nullptr;
+    const int tapped = tapLoop ? tapSamples : 0;
+    if (tapped > 0)
+      engine->ProcessBlock(leftOut, leftOut, wetRight, (size_t)tapped,
+                           analyzerTapBuffer.data());
+    if (numSamples > tapped)
+      engine->ProcessBlock(leftOut + tapped, leftOut + tapped,
+                           wetRight != nullptr ? wetRight + tapped : nullptr,
+                           (size_t)(numSamples - tapped));
   }
 
+  INFS_PROFILE_MARK(profileDryWetStart);
   float wetMix = dryWet;
   for (int channel = 0; channel < totalNumOutputChannels; ++channel) {
     auto *outData = buffer.getWritePointer(channel);
@@ -581,15 +632,19 @@ void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
           (dryData[i] * (1.0f - currentWet)) + (outData[i] * currentWet);
     }
   }
-
-  outputLevelL = buffer.getMagnitude(0, 0, buffer.getNumSamples());
-  if (totalNumOutputChannels > 1)
-    outputLevelR = buffer.getMagnitude(1, 0, buffer.getNumSamples());
-  else
-    outputLevelR = outputLevelL.load();
+  INFS_PROFILE_SINCE(&profiler, infrasonic::StageProfiler::BlockDryWet,
+                     profileDryWetStart);
+
+  for (int ch = 0; ch < 2; ++ch) {
+    const int srcCh = juce::jmin(ch, totalNumOutputChannels - 1);
+    frame.outputPeak[ch] =
+        buffer.getMagnitude(srcCh, 0, buffer.getNumSamples());
+    frame.outputRms[ch] = buffer.getRMSLevel(srcCh, 0, buffer.getNumSamples());
+  }
 
   // --- Stereo Widening (Post-Process) ---
   if (totalNumOutputChannels > 1 && width != 1.0f) {
+    INFS_PROFILE_SCOPE(&profiler, infrasonic::StageProfiler::BlockWidth);
     auto *leftChannel = buffer.getWritePointer(0);
     auto *rightChannel = buffer.getWritePointer(1);
 
@@ -606,32 +661,166 @@ void DawdreyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
       rightChannel[i] = mid - side;
     }
   }
+
+  // --- Analyzer Tap ---
+  if (tapActive && tapSamples > 0) {
+    if (!tapLoop) {
+      auto *l = buffer.getReadPointer(0);
+      auto *r = buffer.getReadPointer(totalNumOutputChannels > 1 ? 1 : 0);
+      for (int i = 0; i < tapSamples; ++i)
+        analyzerTapBuffer[(size_t)i] = 0.5f * (l[i] + r[i]);
+    }
+    analyzerFifo.push(analyzerTapBuffer.data(), tapSamples);
+  }
+
+  // --- Telemetry ---
+  frame.numSamples = numSamples;
+  frame.loopEnergy =
+      numSamples > 0 ? engine->TakeLoopEnergy() / (2.0f * (float)numSamples)
+                     : 0.0f;
+
+  const auto elapsedTicks =
+      juce::Time::getHighResolutionTicks() - blockStartTicks;
+  frame.cpuSeconds =
+      (float)juce::Time::highResolutionTicksToSeconds(elapsedTicks);
+  if (numSamples > 0 && getSampleRate() > 0.0)
+    frame.cpuLoad =
+        frame.cpuSeconds / (float)((double)numSamples / getSampleRate());
+
+  telemetry.push(frame);
+
+  juce::uint32 activeModules = 0;
+  if (gateEnabled)
+    activeModules |= BlockTimeRecorder::ModuleGate;
+  if (driveEnabled)
+    activeModules |= BlockTimeRecorder::ModuleDrive;
+  // Stages still running out their tails count as active
+  if (engine->GetPitchActivity().IsAwake())
+    activeModules |= BlockTimeRecorder::ModulePitch;
+  if (engine->GetEchoActivity().IsAwake())
+    activeModules |= BlockTimeRecorder::ModuleEcho;
+  if (engine->GetReverbActivity().IsAwake())
+    activeModules |= BlockTimeRecorder::ModuleReverb;
+  if (totalNumOutputChannels > 1 && width != 1.0f)
+    activeModules |= BlockTimeRecorder::ModuleWidth;
+  if (engine->instrumentMode)
+    activeModules |= BlockTimeRecorder::ModuleInstrument;
+  if (tapActive)
+    activeModules |= BlockTimeRecorder::ModuleAnalyzer;
+  blockTimes.endBlock(frame.cpuSeconds, numSamples, getSampleRate(),
+                      activeModules, (int)p[ParamIds::Quality]);
+
+  INFS_PROFILE_SINCE(&profiler, infrasonic::StageProfiler::BlockTotal,
+                     profileBlockStart);
+  INFS_PROFILE_PUBLISH(&profiler, numSamples);
 }
 
 bool DawdreyAudioProcessor::hasEditor() const {
+#ifdef DAWDREY_HEADLESS
+  return false; // Offline tools are built without the editor
+#else
   return true; // (change this to false if you choose to not supply an editor)
+#endif
 }
 
 juce::AudioProcessorEditor *DawdreyAudioProcessor::createEditor() {
+#ifdef DAWDREY_HEADLESS
+  return nullptr;
+#else
   return new DawdreyAudioProcessorEditor(*this);
+#endif
 }
 
 void DawdreyAudioProcessor::getStateInformation(juce::MemoryBlock &destData) {
-  auto state = apvts.copyState();
-  std::unique_ptr<juce::XmlElement> xml(state.createXml());
-  copyXmlToBinary(*xml, destData);
+  destData.setSize((size_t)(kStateHeaderSize +
+                            ParamIds::Count * kStateEntrySize));
+
+  // MemoryOutputStream writes little-endian
+  juce::MemoryOutputStream out(destData, false);
+  out.writeInt((int)kStateMagic);
+  out.writeShort((short)kStateVersion);
+  out.writeShort((short)ParamIds::Count);
+  for (size_t i = 0; i < rawParams.size(); ++i) {
+    out.writeInt((int)ParamIds::kHashes[i]);
+    out.writeFloat(rawParams[i]->load());
+  }
+}
+
+bool DawdreyAudioProcessor::loadBinaryState(const void *data,
+                                            int sizeInBytes) {
+  const auto *bytes = static_cast<const juce::uint8 *>(data);
+  if (bytes == nullptr || sizeInBytes < kStateHeaderSize ||
+      juce::ByteOrder::littleEndianInt(bytes) != kStateMagic)
+    return false;
+
+  const auto version = juce::ByteOrder::littleEndianShort(bytes + 4);
+  const int count = juce::ByteOrder::littleEndianShort(bytes + 6);
+  if (version == 0 || version > kStateVersion ||
+      sizeInBytes < kStateHeaderSize + count * kStateEntrySize)
+    return false;
+
+  // Parameters the state does not mention keep their values, as with XML
+  ParameterSnapshot values;
+  for (size_t i = 0; i < rawParams.size(); ++i)
+    values[i] = rawParams[i]->load();
+
+  for (int e = 0; e < count; ++e) {
+    const auto *entry = bytes + kStateHeaderSize + e * kStateEntrySize;
+    const auto idHash = juce::ByteOrder::littleEndianInt(entry);
+    const float value =
+        std::bit_cast<float>(juce::ByteOrder::littleEndianInt(entry + 4));
+
+    // States from this build list the parameters in ParamIds order
+    const bool inOrder =
+        e < ParamIds::Count && ParamIds::kHashes[(size_t)e] == idHash;
+    const int index = inOrder ? e : ParamIds::indexOfHash(idHash);
+    if (index >= 0 && std::isfinite(value))
+      values[(size_t)index] = value;
+  }
+
+  presetManager->applySnapshot(values);
+  return true;
 }
 
 void DawdreyAudioProcessor::setStateInformation(const void *data,
                                                 int sizeInBytes) {
+  loadHostState(data, sizeInBytes);
+}
+
+bool DawdreyAudioProcessor::loadHostState(const void *data, int sizeInBytes) {
+  if (loadBinaryState(data, sizeInBytes)) {
+    blockTimes.notePresetLoad();
+    return true;
+  }
+
+  // XML states saved before the binary format
   std::unique_ptr<juce::XmlElement> xmlState(
       getXmlFromBinary(data, sizeInBytes));
 
-  if (xmlState.get() != nullptr) {
-    if (xmlState->hasTagName(apvts.state.getType())) {
-      apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
-    }
+  if (xmlState == nullptr || !xmlState->hasTagName(apvts.state.getType()))
+    return false;
+
+  presetManager->replaceState(juce::ValueTree::fromXml(*xmlState));
+  blockTimes.notePresetLoad();
+  return true;
+}
+
+juce::var DawdreyAudioProcessor::createTimingReport() const {
+  juce::StringArray parameterIds;
+  for (auto *param : getParameters()) {
+    if (auto *p = dynamic_cast<juce::AudioProcessorParameterWithID *>(param))
+      parameterIds.add(p->getParameterID());
+    else
+      parameterIds.add(param->getName(64));
+  }
+
+  auto report = blockTimes.createReport(parameterIds);
+  if (auto *object = report.getDynamicObject()) {
+    object->setProperty("preset", presetManager->getCurrentPreset());
+    object->setProperty("sample_rate", getSampleRate());
+    object->setProperty("block_size", getBlockSize());
   }
+  return report;
 }
 
 juce::AudioProcessor *JUCE_CALLTYPE createPluginFilter() {
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "BlockTimeRecorder.h"
 #include "DSP/FeedbackSynthEngine.h"
 #include "DSP/PitchShifter.h"
 #include "DSP/SimpleLFO.h"
+#include "ParameterIds.h"
 #include "PresetManager.h"
+#include "PresetSwitcher.h"
+#include "Telemetry.h"
 #include <JuceHeader.h>
 
 class DawdreyAudioProcessor : public juce::AudioProcessor {
@@ -61,57 +65,58 @@ public:
   void getStateInformation(juce::MemoryBlock &destData) override;
   void setStateInformation(const void *data, int sizeInBytes) override;
 
+  // What setStateInformation() does, for tools: loads the binary state
+  // getStateInformation() writes, or an XML state from older versions.
+  // False (and nothing changed) if data is neither.
+  bool loadHostState(const void *data, int sizeInBytes);
+
   juce::UndoManager undoManager;
 
   juce::AudioProcessorValueTreeState apvts;
   std::unique_ptr<PresetManager> presetManager;
 
-  std::atomic<float> lfo1Value{0.0f};
-  std::atomic<float> lfo2Value{0.0f};
-  std::atomic<float> lfo3Value{0.0f};
+  // Preset changes reach the audio thread through here, as one snapshot
+  PresetSwitcher presetSwitcher;
+
+  // Per-block levels, LFO values, loop energy and CPU time for the editor
+  TelemetryFifo telemetry;
+
+  // Per-stage timings, only filled in builds with INFS_PROFILING
+  infrasonic::StageProfiler profiler;
+
+  // Block time histogram and slowest blocks, always on
+  BlockTimeRecorder blockTimes;
+  juce::var createTimingReport() const;
 
-  std::atomic<float> inputLevelL{0.0f};
-  std::atomic<float> inputLevelR{0.0f};
-  std::atomic<float> outputLevelL{0.0f};
-  std::atomic<float> outputLevelR{0.0f};
+  // Scope/spectrum tap. Only fed while an analyzer is showing; taps either
+  // the output or the signal written into the feedback delay lines.
+  SampleFifo analyzerFifo;
+  std::atomic<bool> analyzerActive{false};
+  std::atomic<bool> analyzerTapsLoop{false};
 
   float gateCurrentGain = 0.0f;
 
-  juce::AudioParameterFloat *freqParam = nullptr;
-  juce::AudioParameterFloat *fbGainParam = nullptr;
-  juce::AudioParameterFloat *fbDelayParam = nullptr;
-  juce::AudioParameterFloat *fbLpfParam = nullptr;
-  juce::AudioParameterFloat *fbHpfParam = nullptr;
-  juce::AudioParameterFloat *verbMixParam = nullptr;
-  juce::AudioParameterFloat *verbDecayParam = nullptr;
-  juce::AudioParameterFloat *echoSendParam = nullptr;
-  juce::AudioParameterFloat *echoTimeParam = nullptr;
-  juce::AudioParameterFloat *echoFbParam = nullptr;
-  juce::AudioParameterFloat *dryWetParam = nullptr;
-  juce::AudioParameterFloat *widthParam = nullptr;
-
-  juce::AudioParameterBool *gateEnabledParam = nullptr;
-  juce::AudioParameterFloat *gateThreshParam = nullptr;
-  juce::AudioParameterFloat *gateReleaseParam = nullptr;
-
-  juce::AudioParameterBool *driveEnabledParam = nullptr;
-  juce::AudioParameterFloat *driveAmountParam = nullptr;
-  juce::AudioParameterFloat *driveGainParam = nullptr;
-
-  juce::AudioParameterBool *pitchEnabledParam = nullptr;
-  juce::AudioParameterFloat *pitchShiftParam = nullptr;
-  juce::AudioParameterFloat *pitchFineParam = nullptr;
-
-  juce::AudioParameterBool *instrumentModeParam = nullptr;
   std::atomic<int> lastMidiNote{69};
 
 private:
-  infrasonic::FeedbackSynth::Engine engine;
+  // Created on the first prepareToPlay, so instances that are only scanned
+  // or loaded never allocate delay lines and reverb memory
+  std::unique_ptr<infrasonic::FeedbackSynth::Engine> engine;
   daisysp::SimpleLFO lfo1;
   daisysp::SimpleLFO lfo2;
   daisysp::SimpleLFO lfo3;
 
+  std::vector<float> analyzerTapBuffer;
+
+  // Indexed by ParamIds: the parameters and their plain-value atomics
+  std::array<juce::RangedAudioParameter *, ParamIds::Count> parameters{};
+  std::array<std::atomic<float> *, ParamIds::Count> rawParams{};
+
   juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+  // The binary state getStateInformation() writes; false (and nothing
+  // changed) if data is not one
+  bool loadBinaryState(const void *data, int sizeInBytes);
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DawdreyAudioProcessor)
 };
@@ -0,0 +1,193 @@
+#include "PresetBank.h"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+namespace {
+static_assert(sizeof(PresetBank::Header) == 36, "Header layout changed");
+
+juce::uint32 readUInt32(const juce::uint8 *data) {
+  return juce::ByteOrder::littleEndianInt(data);
+}
+
+std::string_view toStringView(const juce::String &text) {
+  return {text.toRawUTF8(), text.getNumBytesAsUTF8()};
+}
+} // namespace
+
+bool PresetBank::open(const juce::File &bankFile) {
+  close();
+
+  auto mapped = std::make_unique<juce::MemoryMappedFile>(
+      bankFile, juce::MemoryMappedFile::readOnly);
+  const auto *data = static_cast<const juce::uint8 *>(mapped->getData());
+  const auto fileSize = (juce::uint64)mapped->getSize();
+  if (data == nullptr || fileSize < sizeof(Header))
+    return false;
+
+  Header h;
+  h.magic = readUInt32(data);
+  h.version = juce::ByteOrder::littleEndianShort(data + 4);
+  h.headerSize = juce::ByteOrder::littleEndianShort(data + 6);
+  h.numPresets = readUInt32(data + 8);
+  h.numParameters = readUInt32(data + 12);
+  h.parametersOffset = readUInt32(data + 16);
+  h.recordsOffset = readUInt32(data + 20);
+  h.recordSize = readUInt32(data + 24);
+  h.stringsOffset = readUInt32(data + 28);
+  h.stringsSize = readUInt32(data + 32);
+
+  if (h.magic != kMagic || h.version == 0 || h.version > kVersion ||
+      h.headerSize < sizeof(Header))
+    return false;
+
+  auto fits = [fileSize](juce::uint64 offset, juce::uint64 bytes) {
+    return offset + bytes <= fileSize;
+  };
+  const auto valuesSize = (juce::uint64)h.numParameters * 4;
+  if (!fits(h.parametersOffset, valuesSize) ||
+      h.recordSize < kRecordHeaderSize + valuesSize ||
+      !fits(h.recordsOffset, (juce::uint64)h.numPresets * h.recordSize) ||
+      h.stringsSize == 0 || !fits(h.stringsOffset, h.stringsSize) ||
+      data[h.stringsOffset + h.stringsSize - 1] != 0) // Strings terminate
+    return false;
+
+  columns.fill(-1);
+  for (juce::uint32 c = 0; c < h.numParameters; ++c) {
+    const auto columnHash = readUInt32(data + h.parametersOffset + c * 4);
+    if (const int i = ParamIds::indexOfHash(columnHash); i >= 0)
+      columns[(size_t)i] = (int)c;
+  }
+
+  header = h;
+  map = std::move(mapped);
+  file = bankFile;
+  return true;
+}
+
+void PresetBank::close() {
+  map.reset();
+  file = juce::File();
+  header = Header{};
+}
+
+const juce::uint8 *PresetBank::getRecord(int index) const {
+  jassert(juce::isPositiveAndBelow(index, size()));
+  return static_cast<const juce::uint8 *>(map->getData()) +
+         header.recordsOffset + (size_t)index * header.recordSize;
+}
+
+const char *PresetBank::getString(juce::uint32 offset) const {
+  if (offset >= header.stringsSize)
+    return "";
+  return static_cast<const char *>(map->getData()) + header.stringsOffset +
+         offset;
+}
+
+const char *PresetBank::getName(int index) const {
+  return getString(readUInt32(getRecord(index) + 4));
+}
+
+const char *PresetBank::getCategory(int index) const {
+  return getString(readUInt32(getRecord(index) + 8));
+}
+
+const char *PresetBank::getTags(int index) const {
+  return getString(readUInt32(getRecord(index) + 12));
+}
+
+int PresetBank::indexOf(const juce::String &name) const {
+  const auto nameHash = hash(toStringView(name));
+  const char *raw = name.toRawUTF8();
+
+  for (int i = 0; i < size(); ++i) {
+    const auto *record = getRecord(i);
+    if (readUInt32(record) == nameHash &&
+        std::strcmp(getString(readUInt32(record + 4)), raw) == 0)
+      return i;
+  }
+  return -1;
+}
+
+void PresetBank::getValues(int index, ParameterSnapshot &values) const {
+  const auto *record = getRecord(index) + kRecordHeaderSize;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (columns[i] < 0)
+      continue;
+    // A corrupt bank must not put NaN or Inf into the feedback loop;
+    // those parameters keep their values, as in the binary host state
+    const float value =
+        std::bit_cast<float>(readUInt32(record + columns[i] * 4));
+    if (std::isfinite(value))
+      values[i] = value;
+  }
+}
+
+bool PresetBank::write(const juce::File &bankFile,
+                       const std::vector<Preset> &presets) {
+  // Repeated strings (mostly categories) are stored once
+  juce::MemoryOutputStream strings;
+  std::map<juce::String, juce::uint32> stringOffsets;
+  auto addString = [&](const juce::String &text) {
+    const auto [it, inserted] =
+        stringOffsets.emplace(text, (juce::uint32)strings.getDataSize());
+    if (inserted)
+      strings.write(text.toRawUTF8(), text.getNumBytesAsUTF8() + 1);
+    return it->second;
+  };
+  addString({});
+
+  Header h{};
+  h.magic = kMagic;
+  h.version = kVersion;
+  h.headerSize = sizeof(Header);
+  h.numPresets = (juce::uint32)presets.size();
+  h.numParameters = ParamIds::Count;
+  h.parametersOffset = sizeof(Header);
+  h.recordsOffset = h.parametersOffset + h.numParameters * 4;
+  h.recordSize = kRecordHeaderSize + h.numParameters * 4;
+
+  juce::MemoryOutputStream records;
+  for (const auto &preset : presets) {
+    records.writeInt((int)hash(toStringView(preset.name)));
+    records.writeInt((int)addString(preset.name));
+    records.writeInt((int)addString(preset.category));
+    records.writeInt((int)addString(preset.tags));
+    for (const float value : preset.values)
+      records.writeFloat(value);
+  }
+
+  h.stringsOffset = h.recordsOffset + (juce::uint32)records.getDataSize();
+  h.stringsSize = (juce::uint32)strings.getDataSize();
+
+  juce::TemporaryFile temp(bankFile);
+  {
+    auto out = temp.getFile().createOutputStream();
+    if (out == nullptr)
+      return false;
+
+    // OutputStream writes little-endian
+    out->writeInt((int)h.magic);
+    out->writeShort((short)h.version);
+    out->writeShort((short)h.headerSize);
+    out->writeInt((int)h.numPresets);
+    out->writeInt((int)h.numParameters);
+    out->writeInt((int)h.parametersOffset);
+    out->writeInt((int)h.recordsOffset);
+    out->writeInt((int)h.recordSize);
+    out->writeInt((int)h.stringsOffset);
+    out->writeInt((int)h.stringsSize);
+
+    for (const auto idHash : ParamIds::kHashes)
+      out->writeInt((int)idHash);
+
+    out->write(records.getData(), records.getDataSize());
+    out->write(strings.getData(), strings.getDataSize());
+    out->flush();
+    if (out->getStatus().failed())
+      return false;
+  }
+
+  return temp.overwriteTargetFileWithTemporary();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include "PresetSwitcher.h"
+#include <JuceHeader.h>
+#include <string_view>
+#include <vector>
+
+// Binary preset bank (.dwbank), read through a read-only memory map.
+//
+// Layout, little-endian, offsets from the start of the file:
+//   Header
+//   uint32 idHashes[numParameters]            (ParamIds::hash, column order)
+//   Record[numPresets], recordSize bytes each:
+//     uint32 nameHash, nameOffset, categoryOffset, tagsOffset
+//     float values[numParameters]               (plain values)
+//   String table: NUL-terminated UTF-8, offsets relative to its start
+//
+// Opening a bank checks the header and matches its columns to ParamIds once;
+// browsing and applying presets then read straight from the mapped file
+// without parsing or allocating. Columns this build does not know are
+// skipped and parameters the bank lacks are left alone, so banks survive
+// parameters being added or removed. XML stays the interchange format.
+class PresetBank {
+public:
+  static constexpr juce::uint32 kMagic = 0x4b425744; // "DWBK"
+  static constexpr juce::uint16 kVersion = 1;
+  static constexpr const char *kFileExtension = ".dwbank";
+
+  struct Header {
+    juce::uint32 magic;
+    juce::uint16 version;
+    juce::uint16 headerSize;
+    juce::uint32 numPresets;
+    juce::uint32 numParameters;
+    juce::uint32 parametersOffset;
+    juce::uint32 recordsOffset;
+    juce::uint32 recordSize;
+    juce::uint32 stringsOffset;
+    juce::uint32 stringsSize;
+  };
+
+  // One preset to write
+  struct Preset {
+    juce::String name;
+    juce::String category;
+    juce::String tags; // Comma separated
+    ParameterSnapshot values{};
+  };
+
+  // Preset names use the same hash as parameter IDs
+  static constexpr juce::uint32 hash(std::string_view text) {
+    return ParamIds::hash(text);
+  }
+
+  // False if the file is missing, not a bank or from a newer version
+  bool open(const juce::File &bankFile);
+  void close();
+  bool isOpen() const { return map != nullptr; }
+  const juce::File &getFile() const { return file; }
+
+  int size() const { return (int)header.numPresets; }
+
+  // Point into the map; valid while the bank stays open
+  const char *getName(int index) const;
+  const char *getCategory(int index) const;
+  const char *getTags(int index) const;
+
+  // -1 when not present
+  int indexOf(const juce::String &name) const;
+
+  // Overwrites the parameters the bank stores; the rest keep their values
+  void getValues(int index, ParameterSnapshot &values) const;
+
+  static bool write(const juce::File &bankFile,
+                    const std::vector<Preset> &presets);
+
+private:
+  const juce::uint8 *getRecord(int index) const;
+  const char *getString(juce::uint32 offset) const;
+
+  std::unique_ptr<juce::MemoryMappedFile> map;
+  juce::File file;
+  Header header{};
+  // Bank column of each ParamIds entry, -1 if the bank does not store it
+  std::array<int, ParamIds::Count> columns{};
+
+  static constexpr juce::uint32 kRecordHeaderSize = 4 * sizeof(juce::uint32);
+};
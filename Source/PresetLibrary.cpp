@@ -0,0 +1,185 @@
+#include "PresetLibrary.h"
+
+namespace {
+// Folder timestamp poll; a full stat of every file happens every
+// kPollsPerFullScan polls to catch presets edited in place
+constexpr int kPollIntervalMs = 1000;
+constexpr int kPollsPerFullScan = 10;
+
+juce::uint64 fnv1a(juce::uint64 hash, const void *data, size_t size) {
+  auto *bytes = static_cast<const juce::uint8 *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+} // namespace
+
+PresetLibrary::PresetLibrary()
+    : juce::Thread("Preset Library"), directory(getDefaultDirectory()) {}
+
+PresetLibrary::~PresetLibrary() { stopThread(4000); }
+
+juce::File PresetLibrary::getDefaultDirectory() {
+#if JUCE_MAC
+  // ~/Library/Audio/Presets/Dawdrey/
+  return juce::File::getSpecialLocation(
+             juce::File::userApplicationDataDirectory)
+      .getChildFile("Audio")
+      .getChildFile("Presets")
+      .getChildFile("Dawdrey");
+#elif JUCE_WINDOWS || JUCE_LINUX
+  // AppData/Roaming/Dawdrey/Presets/ or ~/.config/Dawdrey/Presets/
+  return juce::File::getSpecialLocation(
+             juce::File::userApplicationDataDirectory)
+      .getChildFile("Dawdrey")
+      .getChildFile("Presets");
+#else
+  // Fallback
+  return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+      .getChildFile("Dawdrey")
+      .getChildFile("Presets");
+#endif
+}
+
+void PresetLibrary::ensureStarted() {
+  std::call_once(started, [this] { startThread(juce::Thread::Priority::low); });
+}
+
+std::shared_ptr<const PresetLibrary::Index> PresetLibrary::getIndex() {
+  ensureStarted();
+  {
+    const juce::SpinLock::ScopedLockType lock(indexLock);
+    if (index != nullptr)
+      return index;
+  }
+
+  // Listeners hear about the first scan when it is published
+  static const auto empty = std::make_shared<const Index>();
+  return empty;
+}
+
+std::shared_ptr<const PresetLibrary::Index> PresetLibrary::getCompleteIndex() {
+  ensureStarted();
+  firstScanDone.wait(-1);
+
+  const juce::SpinLock::ScopedLockType lock(indexLock);
+  return index;
+}
+
+void PresetLibrary::refresh() {
+  ensureStarted();
+  rescanRequested = true;
+  notify();
+}
+
+bool PresetLibrary::readEntry(const juce::File &file, Entry &entry) {
+  auto xml = juce::XmlDocument::parse(file);
+  if (xml == nullptr)
+    return false;
+
+  entry.name = file.getFileNameWithoutExtension();
+  entry.category = xml->getStringAttribute("category");
+  entry.tags = juce::StringArray::fromTokens(xml->getStringAttribute("tags"),
+                                             ",", "");
+  entry.tags.trim();
+  entry.tags.removeEmptyStrings();
+  entry.modified = file.getLastModificationTime();
+  entry.size = file.getSize();
+  entry.file = file;
+
+  // Sorted by ID so the digest does not depend on attribute order
+  std::vector<std::pair<juce::String, float>> values;
+  for (auto *param : xml->getChildWithTagNameIterator("PARAM"))
+    values.emplace_back(param->getStringAttribute("id"),
+                        (float)param->getDoubleAttribute("value"));
+  std::sort(values.begin(), values.end());
+
+  juce::uint64 digest = 14695981039346656037ull;
+  for (const auto &[id, value] : values) {
+    digest = fnv1a(digest, id.toRawUTF8(), id.getNumBytesAsUTF8());
+    digest = fnv1a(digest, &value, sizeof(value));
+  }
+  entry.digest = digest;
+  return true;
+}
+
+bool PresetLibrary::directoryChanged() {
+  const auto time = directory.getLastModificationTime();
+  if (time == lastDirectoryTime)
+    return false;
+
+  lastDirectoryTime = time;
+  return true;
+}
+
+void PresetLibrary::rescan() {
+  std::shared_ptr<const Index> previous;
+  {
+    const juce::SpinLock::ScopedLockType lock(indexLock);
+    previous = index;
+  }
+
+  auto next = std::make_shared<Index>();
+  bool changed = previous == nullptr;
+
+  for (const auto &item :
+       juce::RangedDirectoryIterator(directory, false, "*.xml")) {
+    if (threadShouldExit())
+      return;
+
+    const auto file = item.getFile();
+    const auto name = file.getFileNameWithoutExtension();
+
+    // Unchanged files keep their metadata
+    const Entry *cached = previous != nullptr ? previous->find(name) : nullptr;
+    if (cached != nullptr && cached->modified == item.getModificationTime() &&
+        cached->size == item.getFileSize()) {
+      next->entries.push_back(*cached);
+      continue;
+    }
+
+    Entry entry;
+    if (readEntry(file, entry)) {
+      next->entries.push_back(std::move(entry));
+      changed = true;
+    }
+  }
+
+  std::sort(next->entries.begin(), next->entries.end(),
+            [](const Entry &a, const Entry &b) {
+              return a.name.compareNatural(b.name) < 0;
+            });
+
+  next->names.ensureStorageAllocated((int)next->entries.size());
+  for (size_t i = 0; i < next->entries.size(); ++i) {
+    next->names.add(next->entries[i].name);
+    next->positions.emplace(next->entries[i].name, (int)i);
+  }
+
+  if (!changed && previous->names != next->names)
+    changed = true;
+  if (!changed)
+    return;
+
+  {
+    const juce::SpinLock::ScopedLockType lock(indexLock);
+    index = std::move(next);
+  }
+  sendChangeMessage();
+}
+
+void PresetLibrary::run() {
+  while (!threadShouldExit()) {
+    const bool requested = rescanRequested.exchange(false);
+    const bool fullScan = ++pollsSinceFullScan >= kPollsPerFullScan;
+    if (directoryChanged() || requested || fullScan) {
+      pollsSinceFullScan = 0;
+      rescan();
+      firstScanDone.signal();
+    }
+
+    wait(kPollIntervalMs);
+  }
+}
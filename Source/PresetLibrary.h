@@ -0,0 +1,93 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// In-memory index of the user preset folder, shared by every plugin instance
+// in the process (use through juce::SharedResourcePointer).
+//
+// A background thread builds the index and then polls the folder, rescanning
+// when it changes; unchanged files keep their cached metadata, so only new or
+// edited presets are parsed. The thread starts on first use, so creating
+// plugin instances (e.g. during host scans) never touches the disk. Readers
+// get an immutable snapshot, so lookups by name or position never touch the
+// disk or wait for a scan. Listeners get a change message whenever a new
+// snapshot is published, including the first one.
+class PresetLibrary : public juce::ChangeBroadcaster, private juce::Thread {
+public:
+  struct Entry {
+    juce::String name; // File name without extension
+    juce::String category;
+    juce::StringArray tags;
+    juce::Time modified;
+    juce::int64 size = 0;
+    // Hash of the parameter IDs and values, equal for identical patches
+    juce::uint64 digest = 0;
+    juce::File file;
+  };
+
+  struct Index {
+    // Sorted by name (natural order, case-insensitive)
+    std::vector<Entry> entries;
+    juce::StringArray names;
+
+    int size() const { return (int)entries.size(); }
+
+    // -1 when not present
+    int indexOf(const juce::String &name) const {
+      auto it = positions.find(name);
+      return it != positions.end() ? it->second : -1;
+    }
+
+    const Entry *find(const juce::String &name) const {
+      const int i = indexOf(name);
+      return i >= 0 ? &entries[(size_t)i] : nullptr;
+    }
+
+    struct NameHash {
+      size_t operator()(const juce::String &s) const { return s.hash(); }
+    };
+    std::unordered_map<juce::String, int, NameHash> positions;
+  };
+
+  PresetLibrary();
+  ~PresetLibrary() override;
+
+  static juce::File getDefaultDirectory();
+  const juce::File &getDirectory() const { return directory; }
+
+  // Current snapshot; empty until the first scan has been published
+  std::shared_ptr<const Index> getIndex();
+
+  // Like getIndex(), but waits for the first scan. Only for operations that
+  // need every preset (e.g. exporting a bank).
+  std::shared_ptr<const Index> getCompleteIndex();
+
+  // Schedules a rescan, e.g. right after saving or deleting a preset
+  void refresh();
+
+  // Reads the cached metadata of a single preset file (XML)
+  static bool readEntry(const juce::File &file, Entry &entry);
+
+private:
+  void ensureStarted();
+  void run() override;
+  void rescan();
+  bool directoryChanged();
+
+  const juce::File directory;
+
+  juce::SpinLock indexLock;
+  std::shared_ptr<const Index> index;
+
+  std::once_flag started;
+  juce::WaitableEvent firstScanDone{true};
+  std::atomic<bool> rescanRequested{true};
+  juce::Time lastDirectoryTime;
+  int pollsSinceFullScan = 0;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetLibrary)
+};
@@ -1,13 +1,89 @@
 #include "PresetManager.h"
 
-PresetManager::PresetManager(juce::AudioProcessorValueTreeState &apvts)
-    : valueTreeState(apvts) {
-  const auto defaultDirectory = getPresetsDirectory();
-  if (!defaultDirectory.exists()) {
-    defaultDirectory.createDirectory();
+namespace {
+const FactoryPreset *findFactoryPreset(const juce::String &name) {
+  for (const auto &preset : getFactoryPresets())
+    if (name == preset.name)
+      return &preset;
+  return nullptr;
+}
+
+// States and presets saved before the quality tiers ran the plain loop
+// clipper
+juce::ValueTree withLegacyDefaults(const juce::ValueTree &state) {
+  if (state.getChildWithProperty("id", "quality").isValid())
+    return state;
+
+  auto upgraded = state.createCopy();
+  upgraded.appendChild(
+      juce::ValueTree("PARAM", {{"id", "quality"}, {"value", 0}}), nullptr);
+  return upgraded;
+}
+} // namespace
+
+// No disk access or parameter changes here: hosts create instances during
+// plugin scans, and the factory bank lives in the binary
+PresetManager::PresetManager(juce::AudioProcessorValueTreeState &apvts,
+                             PresetSwitcher *presetSwitcher)
+    : valueTreeState(apvts), switcher(presetSwitcher) {
+  for (int i = 0; i < ParamIds::Count; ++i) {
+    parameters[(size_t)i] = apvts.getParameter(ParamIds::kIds[i]);
+    jassert(parameters[(size_t)i] != nullptr);
+  }
+}
+
+ParameterSnapshot
+PresetManager::createSnapshot(const juce::ValueTree &state) const {
+  ParameterSnapshot values{};
+  for (int i = 0; i < ParamIds::Count; ++i) {
+    auto *param = parameters[(size_t)i];
+    if (param == nullptr)
+      continue;
+
+    const auto child = state.getChildWithProperty("id", ParamIds::kIds[i]);
+    const float value =
+        child.isValid() ? (float)child.getProperty("value")
+                        : param->convertFrom0to1(param->getValue());
+    // Same clamping and snapping the parameter itself applies
+    values[(size_t)i] = param->convertFrom0to1(param->convertTo0to1(value));
+  }
+  return values;
+}
+
+ParameterSnapshot PresetManager::getDefaultSnapshot() const {
+  ParameterSnapshot values{};
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (auto *param = parameters[i])
+      values[i] = param->convertFrom0to1(param->getDefaultValue());
+  }
+  return values;
+}
+
+void PresetManager::applySnapshot(const ParameterSnapshot &values) {
+  // A host state load and an editor preset load may overlap; the parameters
+  // must end up holding the snapshot staged last
+  const juce::ScopedLock lock(loadLock);
+  const auto generation = switcher != nullptr ? switcher->stage(values) : 0;
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (auto *param = parameters[i])
+      param->setValueNotifyingHost(param->convertTo0to1(values[i]));
   }
 
-  createFactoryPresets();
+  if (switcher != nullptr)
+    switcher->committed(generation);
+}
+
+void PresetManager::replaceState(const juce::ValueTree &savedState) {
+  const auto state = withLegacyDefaults(savedState);
+  const juce::ScopedLock lock(loadLock);
+  const auto generation =
+      switcher != nullptr ? switcher->stage(createSnapshot(state)) : 0;
+
+  valueTreeState.replaceState(state);
+
+  if (switcher != nullptr)
+    switcher->committed(generation);
 }
 
 void PresetManager::savePreset(const juce::String &presetName) {
@@ -15,11 +91,14 @@ void PresetManager::savePreset(const juce::String &presetName) {
     return;
 
   const auto xml = valueTreeState.copyState().createXml();
-  const auto presetFile =
-      getPresetsDirectory().getChildFile(presetName + ".xml");
+  const auto directory = getPresetsDirectory();
+  if (!directory.createDirectory())
+    return;
 
+  const auto presetFile = directory.getChildFile(presetName + ".xml");
   if (xml->writeTo(presetFile)) {
     currentPresetName = presetName;
+    library->refresh();
     DBG("Preset saved: " + presetName);
   }
 }
@@ -34,6 +113,7 @@ void PresetManager::deletePreset(const juce::String &presetName) {
     if (!presetFile.deleteFile()) {
       DBG("Failed to delete preset: " + presetName);
     }
+    library->refresh();
   }
 }
 
@@ -41,30 +121,38 @@ void PresetManager::loadPreset(const juce::String &presetName) {
   if (presetName.isEmpty())
     return;
 
+  // Presets saved since the last scan are not indexed yet
+  const auto *entry = library->getIndex()->find(presetName);
   const auto presetFile =
-      getPresetsDirectory().getChildFile(presetName + ".xml");
-  if (!presetFile.existsAsFile())
+      entry != nullptr
+          ? entry->file
+          : getPresetsDirectory().getChildFile(presetName + ".xml");
+  if (!presetFile.existsAsFile()) {
+    if (const auto *factory = findFactoryPreset(presetName))
+      applyFactoryPreset(*factory);
+    else if (const int bankIndex = bank.indexOf(presetName); bankIndex >= 0)
+      loadBankPreset(bankIndex);
     return;
+  }
 
   auto xmlElement = juce::XmlDocument::parse(presetFile);
   if (xmlElement) {
-    valueTreeState.replaceState(juce::ValueTree::fromXml(*xmlElement));
+    replaceState(juce::ValueTree::fromXml(*xmlElement));
     currentPresetName = presetName;
     DBG("Preset loaded: " + presetName);
+
+    if (onPresetLoaded)
+      onPresetLoaded();
   }
 }
 
 void PresetManager::loadInitPreset() {
-  auto &state = valueTreeState.state;
-
-  auto &processor = valueTreeState.processor;
-  for (auto *param : processor.getParameters()) {
-    if (auto *p = dynamic_cast<juce::AudioProcessorParameterWithID *>(param)) {
-      p->setValueNotifyingHost(p->getDefaultValue());
-    }
-  }
+  applySnapshot(getDefaultSnapshot());
 
   currentPresetName = "Init";
+
+  if (onPresetLoaded)
+    onPresetLoaded();
 }
 
 void PresetManager::loadPresetFromFile(const juce::File &file) {
@@ -73,13 +161,16 @@ void PresetManager::loadPresetFromFile(const juce::File &file) {
 
   auto xmlElement = juce::XmlDocument::parse(file);
   if (xmlElement) {
-    valueTreeState.replaceState(juce::ValueTree::fromXml(*xmlElement));
+    replaceState(juce::ValueTree::fromXml(*xmlElement));
 
     auto presetName = file.getFileNameWithoutExtension();
     savePreset(presetName);
 
     currentPresetName = presetName;
     DBG("Preset imported: " + presetName);
+
+    if (onPresetLoaded)
+      onPresetLoaded();
   }
 }
 
@@ -91,37 +182,129 @@ void PresetManager::savePresetToFile(const juce::String &presetName,
   }
 }
 
+bool PresetManager::openBank(const juce::File &file) {
+  return bank.open(file);
+}
+
+void PresetManager::loadBankPreset(int index) {
+  if (!juce::isPositiveAndBelow(index, bank.size()))
+    return;
+
+  // Parameters an older bank does not store start from their defaults
+  auto values = getDefaultSnapshot();
+  bank.getValues(index, values);
+  applySnapshot(values);
+
+  currentPresetName = juce::String::fromUTF8(bank.getName(index));
+  DBG("Bank preset loaded: " + currentPresetName);
+
+  if (onPresetLoaded)
+    onPresetLoaded();
+}
+
+bool PresetManager::exportBank(const juce::File &file) {
+  const auto index = library->getCompleteIndex();
+
+  std::vector<PresetBank::Preset> presets;
+  presets.reserve(index->entries.size());
+  for (const auto &entry : index->entries) {
+    auto xml = juce::XmlDocument::parse(entry.file);
+    if (xml == nullptr)
+      continue;
+
+    auto &preset = presets.emplace_back();
+    preset.name = entry.name;
+    preset.category = entry.category;
+    preset.tags = entry.tags.joinIntoString(",");
+    preset.values =
+        createSnapshot(withLegacyDefaults(juce::ValueTree::fromXml(*xml)));
+  }
+
+  // The open bank may be the file being replaced
+  const auto reopen = bank.getFile();
+  if (reopen == file)
+    bank.close();
+
+  const bool written = PresetBank::write(file, presets);
+  if (reopen == file)
+    bank.open(file);
+
+  DBG("Bank exported to: " + file.getFullPathName());
+  return written;
+}
+
+int PresetManager::getNumPresets() const {
+  const auto index = library->getIndex();
+  int numFactory = 0;
+  for (const auto &preset : getFactoryPresets())
+    if (index->indexOf(preset.name) < 0)
+      ++numFactory;
+  return index->size() + numFactory + bank.size();
+}
+
+void PresetManager::loadPresetAt(int position) {
+  const auto index = library->getIndex();
+  if (position < index->size()) {
+    loadPreset(index->entries[(size_t)position].name);
+    return;
+  }
+
+  position -= index->size();
+  for (const auto &preset : getFactoryPresets()) {
+    if (index->indexOf(preset.name) >= 0)
+      continue; // Overridden by a user preset listed above
+    if (position-- == 0) {
+      applyFactoryPreset(preset);
+      return;
+    }
+  }
+
+  loadBankPreset(position);
+}
+
 void PresetManager::loadNextPreset() {
-  const auto allPresets = getAllPresets();
-  if (allPresets.isEmpty())
+  const auto total = getNumPresets();
+  if (total == 0)
     return;
 
-  const auto currentIndex = allPresets.indexOf(currentPresetName);
-  const auto nextIndex = (currentIndex + 1) % allPresets.size();
-  loadPreset(allPresets[nextIndex]);
+  const auto currentIndex = getCurrentPresetIndex();
+  loadPresetAt((currentIndex + 1) % total);
 }
 
 void PresetManager::loadPreviousPreset() {
-  const auto allPresets = getAllPresets();
-  if (allPresets.isEmpty())
+  const auto total = getNumPresets();
+  if (total == 0)
     return;
 
-  const auto currentIndex = allPresets.indexOf(currentPresetName);
-  const auto previousIndex =
-      (currentIndex - 1 + allPresets.size()) % allPresets.size();
-  loadPreset(allPresets[previousIndex]);
+  const auto currentIndex = getCurrentPresetIndex();
+  loadPresetAt((currentIndex - 1 + total) % total);
 }
 
 juce::StringArray PresetManager::getAllPresets() const {
-  juce::StringArray presets;
-  const auto directory = getPresetsDirectory();
-  const auto files =
-      directory.findChildFiles(juce::File::findFiles, false, "*.xml");
+  const auto index = library->getIndex();
+  auto names = index->names;
+  names.ensureStorageAllocated(getNumPresets());
+  for (const auto &preset : getFactoryPresets())
+    if (index->indexOf(preset.name) < 0)
+      names.add(preset.name);
+  for (int i = 0; i < bank.size(); ++i)
+    names.add(juce::String::fromUTF8(bank.getName(i)));
+  return names;
+}
 
-  for (const auto &file : files) {
-    presets.add(file.getFileNameWithoutExtension());
+void PresetManager::applyFactoryPreset(const FactoryPreset &preset) {
+  // Defaults plus the preset's values, switched as one
+  auto values = getDefaultSnapshot();
+  for (const auto &[index, value] : preset.values) {
+    auto *param = parameters[(size_t)index];
+    values[(size_t)index] = param->convertFrom0to1(param->convertTo0to1(value));
   }
-  return presets;
+
+  applySnapshot(values);
+
+  currentPresetName = preset.name;
+  if (onPresetLoaded)
+    onPresetLoaded();
 }
 
 juce::String PresetManager::getCurrentPreset() const {
@@ -129,111 +312,23 @@ juce::String PresetManager::getCurrentPreset() const {
 }
 
 int PresetManager::getCurrentPresetIndex() const {
-  return getAllPresets().indexOf(currentPresetName);
+  const auto index = library->getIndex();
+  if (const int position = index->indexOf(currentPresetName); position >= 0)
+    return position;
+
+  int position = index->size();
+  for (const auto &preset : getFactoryPresets()) {
+    if (index->indexOf(preset.name) >= 0)
+      continue;
+    if (currentPresetName == preset.name)
+      return position;
+    ++position;
+  }
+
+  const int bankIndex = bank.indexOf(currentPresetName);
+  return bankIndex >= 0 ? position + bankIndex : -1;
 }
 
 juce::File PresetManager::getPresetsDirectory() const {
-  juce::File rootDir;
-
-#if JUCE_MAC
-  // ~/Library/Audio/Presets/Dawdrey/
-  rootDir =
-      juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-          .getChildFile("Audio")
-          .getChildFile("Presets")
-          .getChildFile("Dawdrey");
-#elif JUCE_WINDOWS
-  // AppData/Roaming/Dawdrey/Presets/
-  rootDir =
-      juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-          .getChildFile("Dawdrey")
-          .getChildFile("Presets");
-#elif JUCE_LINUX
-  // ~/.config/Dawdrey/Presets/
-  rootDir =
-      juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-          .getChildFile("Dawdrey")
-          .getChildFile("Presets");
-#else
-  // Fallback
-  rootDir = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
-                .getChildFile("Dawdrey")
-                .getChildFile("Presets");
-#endif
-
-  return rootDir;
-}
-
-void PresetManager::createFactoryPresets() {
-  const auto dir = getPresetsDirectory();
-  if (dir.findChildFiles(juce::File::findFiles, false, "*.xml").size() > 0)
-    return;
-
-  auto createPreset = [&](juce::String name,
-                          std::map<juce::String, float> params) {
-    loadInitPreset();
-
-    for (auto &p : params) {
-      if (auto *param = valueTreeState.getParameter(p.first)) {
-        if (auto *rangedParam =
-                dynamic_cast<juce::RangedAudioParameter *>(param)) {
-          float normalized = rangedParam->convertTo0to1(p.second);
-          rangedParam->setValueNotifyingHost(normalized);
-        }
-      }
-    }
-
-    savePreset(name);
-  };
-
-  // 1. Factory - Lush Pad
-  // Slow attack, reverb, chorus-y modulation
-  std::map<juce::String, float> lushPad;
-  lushPad["freq"] = 0.2f; // Low pitch
-  lushPad["verb_mix"] = 0.6f;
-  lushPad["verb_decay"] = 0.8f;
-  lushPad["width"] = 1.5f;
-  lushPad["lfo1_rate"] = 0.2f;
-  lushPad["lfo1_depth"] = 0.3f;
-  lushPad["lfo1_target"] = 1.0f; // Freq
-  createPreset("Factory - Lush Pad", lushPad);
-
-  // 2. Factory - Rhythmic Gater
-  // Gate enabled, LFO on Gate Thresh
-  std::map<juce::String, float> rhythmicGater;
-  rhythmicGater["gate_enabled"] = 1.0f;
-  rhythmicGater["gate_thresh"] = -20.0f;
-  rhythmicGater["lfo1_sync"] = 1.0f;
-  rhythmicGater["lfo1_div"] = 10.0f;    // 1/16
-  rhythmicGater["lfo1_shape"] = 4.0f;   // Square
-  rhythmicGater["lfo1_target"] = 13.0f; // Gate Thresh
-  rhythmicGater["lfo1_depth"] = 0.8f;
-  createPreset("Factory - Rhythmic Gater", rhythmicGater);
-
-  // 3. Factory - Deep Space
-  // High feedback, long delay, echo
-  std::map<juce::String, float> deepSpace;
-  deepSpace["fb_gain"] = 0.95f;
-  deepSpace["fb_delay"] = 0.5f;
-  deepSpace["echo_send"] = 0.7f;
-  deepSpace["echo_time"] = 1.5f;
-  deepSpace["echo_fb"] = 0.8f;
-  deepSpace["verb_mix"] = 0.8f;
-  createPreset("Factory - Deep Space", deepSpace);
-
-  // 4. Factory - Acid Lead
-  // Drive, Saw LFO on Filter
-  std::map<juce::String, float> acidLead;
-  acidLead["drive_enabled"] = 1.0f;
-  acidLead["drive_amount"] = 0.6f;
-  acidLead["drive_gain"] = -3.0f;
-  acidLead["fb_lpf"] = 2000.0f;
-  acidLead["lfo1_rate"] = 8.0f;
-  acidLead["lfo1_shape"] = 2.0f;  // Saw
-  acidLead["lfo1_target"] = 4.0f; // FB LPF
-  acidLead["lfo1_depth"] = 0.7f;
-  createPreset("Factory - Acid Lead", acidLead);
-
-  // Reset to Init after creation
-  loadInitPreset();
+  return library->getDirectory();
 }
@@ -1,31 +1,80 @@
 #pragma once
 
+#include "FactoryPresets.h"
+#include "PresetBank.h"
+#include "PresetLibrary.h"
+#include "PresetSwitcher.h"
 #include <JuceHeader.h>
 
 class PresetManager
 {
 public:
-    PresetManager(juce::AudioProcessorValueTreeState& apvts);
+    // Loads are staged on the switcher (if any) so the audio thread can
+    // change over to the whole preset at once
+    PresetManager(juce::AudioProcessorValueTreeState& apvts,
+                  PresetSwitcher* presetSwitcher = nullptr);
 
     void savePreset(const juce::String& presetName);
     void deletePreset(const juce::String& presetName);
     void loadPreset(const juce::String& presetName);
     void loadInitPreset();
+    // Applies one of getFactoryPresets(); the factory bank is never
+    // written to disk
+    void applyFactoryPreset(const FactoryPreset& preset);
     void loadNextPreset();
     void loadPreviousPreset();
+    // User presets, then factory presets no user preset overrides, then the
+    // open bank
     juce::StringArray getAllPresets() const;
+    int getNumPresets() const;
     juce::String getCurrentPreset() const;
     int getCurrentPresetIndex() const;
+
+    // Shared preset index; broadcasts a change when the folder changes
+    PresetLibrary& getLibrary() const { return library.get(); }
     
     void loadPresetFromFile(const juce::File& file);
     void savePresetToFile(const juce::String& presetName, const juce::File& file);
 
+    // Binary bank whose presets are listed last. Opening one replaces the
+    // previous bank.
+    bool openBank(const juce::File& file);
+    const PresetBank& getBank() const { return bank; }
+    void loadBankPreset(int index);
+    // Writes every user preset into a single bank file
+    bool exportBank(const juce::File& file);
+
+    // Plain parameter values a state tree would set; parameters missing from
+    // the tree keep their current value, as replaceState() does
+    ParameterSnapshot createSnapshot(const juce::ValueTree& state) const;
+
+    // Stages the state on the switcher, replaces the parameter state and
+    // marks the switch committed. States without a quality entry predate
+    // it and load as Eco.
+    void replaceState(const juce::ValueTree& savedState);
+    // Same for plain values: stages them and sets every parameter to them.
+    // Both are serialised, since hosts may restore state off the message
+    // thread while the editor loads a preset.
+    void applySnapshot(const ParameterSnapshot& values);
+
+    // Called on the loading thread after any preset load
+    std::function<void()> onPresetLoaded;
+
 private:
     void valueTreeRedirected(juce::ValueTree& treeWhichHasBeenChanged);
-    void createFactoryPresets();
+    ParameterSnapshot getDefaultSnapshot() const;
 
     juce::File getPresetsDirectory() const;
+    // Position in getAllPresets()
+    void loadPresetAt(int position);
 
     juce::AudioProcessorValueTreeState& valueTreeState;
-    juce::String currentPresetName;
+    juce::String currentPresetName{"Init"};
+    juce::SharedResourcePointer<PresetLibrary> library;
+    PresetBank bank;
+    PresetSwitcher* switcher = nullptr;
+    // Serialises applySnapshot() and replaceState()
+    juce::CriticalSection loadLock;
+    // Indexed by ParamIds
+    std::array<juce::RangedAudioParameter*, ParamIds::Count> parameters{};
 };
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// Plain (denormalised) value of every parameter, indexed by ParamIds
+using ParameterSnapshot = std::array<float, ParamIds::Count>;
+
+// Hands whole presets to the audio thread and glides to them without
+// clicks. A loading thread stages a snapshot (triple buffer), then writes the
+// same values to the parameters as usual and calls committed() with the
+// generation stage() returned. Loads may come from more than one thread
+// (hosts can restore state off the message thread), so the producer side is
+// serialised with a lock; the audio thread never takes it.
+//
+// On a switch the audio thread ramps every continuous parameter from the
+// values it was playing to the staged ones over kRampSeconds, while the
+// feedback loop keeps running; discrete parameters (choices and toggles)
+// take their new value at the start of the ramp. It only returns to the
+// live parameters once they have caught up. A snapshot staged before
+// anything has played is taken as is.
+class PresetSwitcher {
+public:
+  static constexpr double kRampSeconds = 0.05;
+
+  // Before playback: marks parameters that must not be interpolated
+  void setDiscrete(int index, bool discrete) {
+    discreteParams[(size_t)index] = discrete;
+  }
+
+  // Loading thread. Call before updating the parameters themselves; pass
+  // the result to committed().
+  uint32_t stage(const ParameterSnapshot &values) {
+    const std::lock_guard<std::mutex> lock(producerMutex);
+    auto &slot = slots[(size_t)back];
+    slot.values = values;
+    slot.generation = ++stagedGeneration;
+    back = middle.exchange(back | kDirty) & kIndexMask;
+    return slot.generation;
+  }
+
+  // Loading thread, once the parameters hold the values staged as
+  // generation. A later stage() keeps the audio thread waiting for its own
+  // commit.
+  void committed(uint32_t generation) {
+    const std::lock_guard<std::mutex> lock(producerMutex);
+    if (generation > committedGeneration.load(std::memory_order_relaxed))
+      committedGeneration.store(generation, std::memory_order_release);
+  }
+
+  // Audio thread (or before playback), with the current parameter values
+  void prepare(double sampleRate, const ParameterSnapshot &live) {
+    rampStep = sampleRate > 0.0 ? (float)(1.0 / (kRampSeconds * sampleRate))
+                                : 1.0f;
+    current = live;
+    state = State::Idle;
+    played = false;
+    takePending();
+  }
+
+  // Audio thread, start of every block. live holds this block's parameter
+  // values and must be read before calling. Returns the values the block
+  // should use.
+  const ParameterSnapshot &beginBlock(const ParameterSnapshot &live,
+                                      int numSamples) {
+    if (!played) {
+      takePending();
+      played = true;
+    } else if ((middle.load() & kDirty) != 0) {
+      front = middle.exchange(front) & kIndexMask;
+      // Glide from whatever was playing, even mid-way through a ramp
+      from = current;
+      progress = 0.0f;
+      state = State::Ramping;
+    }
+
+    if (state == State::Ramping) {
+      const auto &target = slots[(size_t)front].values;
+      progress = std::min(progress + rampStep * (float)numSamples, 1.0f);
+      for (size_t i = 0; i < current.size(); ++i)
+        current[i] = discreteParams[i]
+                         ? target[i]
+                         : from[i] + (target[i] - from[i]) * progress;
+      if (progress >= 1.0f)
+        state = State::Holding;
+    } else if (state == State::Holding &&
+               committedGeneration.load(std::memory_order_acquire) >=
+                   slots[(size_t)front].generation) {
+      state = State::Idle;
+    }
+
+    if (state == State::Idle)
+      current = live;
+
+    return current;
+  }
+
+  bool isSwitching() const { return state != State::Idle; }
+
+private:
+  enum class State { Idle, Ramping, Holding };
+
+  // Jumps straight to a staged snapshot, if there is one
+  void takePending() {
+    if ((middle.load() & kDirty) == 0)
+      return;
+    front = middle.exchange(front) & kIndexMask;
+    current = slots[(size_t)front].values;
+    state = State::Holding;
+  }
+
+  struct Slot {
+    ParameterSnapshot values{};
+    uint32_t generation = 0;
+  };
+
+  static constexpr int kIndexMask = 3;
+  static constexpr int kDirty = 4;
+
+  // Triple buffer: the loading thread owns slots[back], the audio thread
+  // slots[front], and middle is swapped between them
+  std::array<Slot, 3> slots;
+  int back = 0;
+  std::atomic<int> middle{1};
+  int front = 2;
+
+  // Guards back and stagedGeneration
+  std::mutex producerMutex;
+  uint32_t stagedGeneration = 0;
+  std::atomic<uint32_t> committedGeneration{0};
+
+  std::array<bool, ParamIds::Count> discreteParams{};
+
+  // Audio thread state
+  ParameterSnapshot current{};
+  ParameterSnapshot from{};
+  State state = State::Idle;
+  float progress = 0.0f;
+  float rampStep = 1.0f;
+  bool played = false;
+};
@@ -0,0 +1,158 @@
+#include "ProfilerPanel.h"
+
+ProfilerPanel::ProfilerPanel(DawdreyAudioProcessor &p) : audioProcessor(p) {
+  setOpaque(true);
+  setSize(360, 330);
+
+  addAndMakeVisible(exportButton);
+  exportButton.setTooltip("Save cumulative stage timings as JSON");
+  exportButton.onClick = [this] { exportJson(); };
+
+  previous = audioProcessor.profiler.GetSnapshot();
+}
+
+ProfilerPanel::~ProfilerPanel() { stopTimer(); }
+
+void ProfilerPanel::visibilityChanged() {
+  if (isVisible()) {
+    previous = audioProcessor.profiler.GetSnapshot();
+    startTimerHz(2);
+  } else {
+    stopTimer();
+  }
+}
+
+void ProfilerPanel::timerCallback() {
+  const auto now = audioProcessor.profiler.GetSnapshot();
+  if (now.blocks == previous.blocks)
+    return;
+
+  for (int i = 0; i < Profiler::NumStages; ++i)
+    stageSeconds[i] =
+        (double)(now.ticks[i] - previous.ticks[i]) / now.ticks_per_second;
+
+  windowSeconds = stageSeconds[Profiler::BlockTotal];
+  const double sampleRate = audioProcessor.getSampleRate();
+  budgetSeconds = sampleRate > 0.0
+                      ? (double)(now.samples - previous.samples) / sampleRate
+                      : 0.0;
+
+  previous = now;
+  repaint();
+}
+
+void ProfilerPanel::paint(juce::Graphics &g) {
+  const auto gold = juce::Colour(0xffd4af37);
+  g.fillAll(juce::Colour(0xff1a1a1a));
+
+  auto area = getLocalBounds().reduced(10);
+  area.removeFromBottom(30); // Export button
+
+  g.setFont(14.0f);
+  g.setColour(gold);
+
+#if !INFS_PROFILING
+  g.drawFittedText("Built without profiling.\nConfigure with "
+                   "-DDAWDREY_PROFILING=ON to enable stage timers.",
+                   area, juce::Justification::centred, 3);
+#else
+  const double load =
+      budgetSeconds > 0.0 ? 100.0 * windowSeconds / budgetSeconds : 0.0;
+  g.drawText("processBlock: " + juce::String(load, 1) + "% of real time",
+             area.removeFromTop(20), juce::Justification::centredLeft);
+  area.removeFromTop(6);
+
+  // Block phases relative to processBlock, engine stages relative to the
+  // engine phase
+  auto drawRow = [&](int stage, double reference, juce::String label) {
+    auto row = area.removeFromTop(19);
+    const double share =
+        reference > 0.0
+            ? juce::jlimit(0.0, 1.0, stageSeconds[stage] / reference)
+            : 0.0;
+
+    g.setColour(juce::Colours::white.withAlpha(0.8f));
+    g.drawText(label, row.removeFromLeft(130),
+               juce::Justification::centredLeft);
+    g.drawText(juce::String(share * 100.0, 1) + "%", row.removeFromRight(50),
+               juce::Justification::centredRight);
+
+    auto bar = row.reduced(4, 4).toFloat();
+    g.setColour(juce::Colours::black.withAlpha(0.4f));
+    g.fillRect(bar);
+    g.setColour(gold.withAlpha(0.8f));
+    g.fillRect(bar.withWidth(bar.getWidth() * (float)share));
+  };
+
+  for (int stage = Profiler::BlockModulation; stage <= Profiler::BlockWidth;
+       ++stage)
+    drawRow(stage, windowSeconds, Profiler::GetStageName(stage));
+
+  area.removeFromTop(8);
+  for (int stage = Profiler::EngineStrings; stage <= Profiler::EngineEcho;
+       ++stage)
+    drawRow(stage, stageSeconds[Profiler::BlockEngine],
+            juce::String("  ") + Profiler::GetStageName(stage));
+#endif
+}
+
+void ProfilerPanel::resized() {
+  exportButton.setBounds(
+      getLocalBounds().reduced(10).removeFromBottom(24).removeFromRight(110));
+}
+
+juce::var ProfilerPanel::createReport(const Profiler::Snapshot &snapshot,
+                                      double sampleRate) {
+  const double total =
+      (double)snapshot.ticks[Profiler::BlockTotal] / snapshot.ticks_per_second;
+  const double audio =
+      sampleRate > 0.0 ? (double)snapshot.samples / sampleRate : 0.0;
+
+  auto *report = new juce::DynamicObject();
+  report->setProperty("sample_rate", sampleRate);
+  report->setProperty("blocks", (juce::int64)snapshot.blocks);
+  report->setProperty("samples", (juce::int64)snapshot.samples);
+  report->setProperty("audio_seconds", audio);
+  report->setProperty("ticks_per_second", snapshot.ticks_per_second);
+
+  juce::Array<juce::var> stages;
+  for (int i = 0; i < Profiler::NumStages; ++i) {
+    const double seconds =
+        (double)snapshot.ticks[i] / snapshot.ticks_per_second;
+
+    auto *stage = new juce::DynamicObject();
+    stage->setProperty("name", Profiler::GetStageName(i));
+    stage->setProperty("seconds", seconds);
+    stage->setProperty("percent_of_block",
+                       total > 0.0 ? 100.0 * seconds / total : 0.0);
+    stage->setProperty("percent_of_realtime",
+                       audio > 0.0 ? 100.0 * seconds / audio : 0.0);
+    stage->setProperty("ns_per_sample",
+                       snapshot.samples > 0
+                           ? 1.0e9 * seconds / (double)snapshot.samples
+                           : 0.0);
+    stages.add(juce::var(stage));
+  }
+  report->setProperty("stages", stages);
+
+  return juce::var(report);
+}
+
+void ProfilerPanel::exportJson() {
+  const auto json = juce::JSON::toString(createReport(
+      audioProcessor.profiler.GetSnapshot(), audioProcessor.getSampleRate()));
+
+  fileChooser = std::make_unique<juce::FileChooser>(
+      "Export Stage Timings",
+      juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+          .getChildFile("dawdrey-profile.json"),
+      "*.json");
+
+  fileChooser->launchAsync(juce::FileBrowserComponent::saveMode |
+                               juce::FileBrowserComponent::canSelectFiles,
+                           [json](const juce::FileChooser &chooser) {
+                             auto file = chooser.getResult();
+                             if (file != juce::File())
+                               file.replaceWithText(json);
+                           });
+}
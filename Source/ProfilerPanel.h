@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include <JuceHeader.h>
+
+// Developer view of DawdreyAudioProcessor::profiler: per-stage share of the
+// processBlock time and of the real-time budget, refreshed twice a second
+// from the difference between two snapshots. Only useful in builds with
+// INFS_PROFILING (CMake option DAWDREY_PROFILING).
+class ProfilerPanel : public juce::Component, private juce::Timer {
+public:
+  explicit ProfilerPanel(DawdreyAudioProcessor &p);
+  ~ProfilerPanel() override;
+
+  void paint(juce::Graphics &) override;
+  void resized() override;
+  void visibilityChanged() override;
+
+  // Cumulative totals since the processor was created, as JSON
+  static juce::var createReport(const infrasonic::StageProfiler::Snapshot &,
+                                double sampleRate);
+
+private:
+  using Profiler = infrasonic::StageProfiler;
+
+  void timerCallback() override;
+  void exportJson();
+
+  DawdreyAudioProcessor &audioProcessor;
+
+  Profiler::Snapshot previous;
+  double stageSeconds[Profiler::NumStages] = {};
+  double windowSeconds = 0.0; // Total processBlock time in the window
+  double budgetSeconds = 0.0; // Real-time duration of the audio in the window
+
+  juce::TextButton exportButton{"Export JSON"};
+  std::unique_ptr<juce::FileChooser> fileChooser;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerPanel)
+};
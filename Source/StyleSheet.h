@@ -1,8 +1,16 @@
 #pragma once
 #include <JuceHeader.h>
+#include <map>
 
 namespace daisysp_gui {
 
+// Slider property holding the modulated position (0-1) drawn as an orb and
+// arc on top of the knob. Absent when the knob is not modulated.
+inline const juce::Identifier &modValueId() {
+  static const juce::Identifier id{"modValue"};
+  return id;
+}
+
 class CustomLookAndFeel : public juce::LookAndFeel_V4 {
 public:
   CustomLookAndFeel() {
@@ -62,54 +70,48 @@ public:
     auto angle =
         rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
 
-    // Outer Ring (Brass)
-    g.setColour(juce::Colour::fromString("FFB5A642"));
-    g.drawEllipse(rx, ry, rw, rw, 2.0f);
-
-    // Inner Circle (Dark)
-    g.setColour(juce::Colour::fromString("FF0F0F0F"));
-    g.fillEllipse(rx + 2, ry + 2, rw - 4, rw - 4);
+    // Static body (brass ring + dark face) comes from a per-size cache
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    g.drawImage(getKnobBody(rw, scale),
+                juce::Rectangle<float>(rx - 1.0f, ry - 1.0f, rw + 2.0f,
+                                       rw + 2.0f));
 
-    juce::Path p;
     auto pointerLength = radius * 0.8f;
     auto pointerThickness = 3.0f;
-    p.addRectangle(-pointerThickness * 0.5f, -radius, pointerThickness,
-                   pointerLength);
-    p.applyTransform(
+    pointerPath.clear();
+    pointerPath.addRectangle(-pointerThickness * 0.5f, -radius,
+                             pointerThickness, pointerLength);
+    pointerPath.applyTransform(
         juce::AffineTransform::rotation(angle).translated(centreX, centreY));
 
     g.setColour(juce::Colour::fromString("FFD4AF37"));
-    g.fillPath(p);
+    g.fillPath(pointerPath);
 
     // Decorative center dot
     g.fillEllipse(centreX - 3, centreY - 3, 6, 6);
 
     // Modulation Indicator
-    if (auto *modValueProp = slider.getProperties().getVarPointer("modValue")) {
+    if (auto *modValueProp = slider.getProperties().getVarPointer(modValueId())) {
       if (!modValueProp->isVoid()) {
         float modVal = (float)*modValueProp;
         float modAngle =
             rotaryStartAngle + modVal * (rotaryEndAngle - rotaryStartAngle);
 
         // Draw Indicator (Small Orb)
-        auto modRadius = radius * 0.85f;
-        juce::Path modPath;
-        modPath.addEllipse(-3.0f, -modRadius, 6.0f, 6.0f);
-        modPath.applyTransform(
-            juce::AffineTransform::rotation(modAngle).translated(centreX,
-                                                                 centreY));
-
+        auto modRadius = radius * 0.85f - 3.0f;
         g.setColour(juce::Colour::fromString("FFFFFFFF").withAlpha(0.8f));
-        g.fillPath(modPath);
+        g.fillEllipse(centreX + modRadius * std::sin(modAngle) - 3.0f,
+                      centreY - modRadius * std::cos(modAngle) - 3.0f, 6.0f,
+                      6.0f);
 
-        juce::Path arc;
         float start = std::min(angle, modAngle);
         float end = std::max(angle, modAngle);
         if (end - start > 0.01f) {
-          arc.addCentredArc(centreX, centreY, radius * 0.9f, radius * 0.9f,
-                            0.0f, start, end, true);
+          modArcPath.clear();
+          modArcPath.addCentredArc(centreX, centreY, radius * 0.9f,
+                                   radius * 0.9f, 0.0f, start, end, true);
           g.setColour(juce::Colour::fromString("FFFFFFFF").withAlpha(0.3f));
-          g.strokePath(arc, juce::PathStrokeType(2.0f));
+          g.strokePath(modArcPath, juce::PathStrokeType(2.0f));
         }
       }
     }
@@ -296,7 +298,37 @@ public:
   }
 
 private:
+  // Knob ring and face rendered once per (diameter, display scale). Every
+  // knob in the editor shares one of a handful of sizes.
+  const juce::Image &getKnobBody(float diameter, float scale) {
+    const auto key = ((juce::int64)juce::roundToInt(diameter * 8.0f) << 16) |
+                     (juce::int64)juce::roundToInt(scale * 100.0f);
+
+    auto &image = knobBodyCache[key];
+    if (!image.isValid()) {
+      const int pixels = juce::roundToInt((diameter + 2.0f) * scale);
+      image = juce::Image(juce::Image::ARGB, pixels, pixels, true);
+
+      juce::Graphics g(image);
+      g.addTransform(juce::AffineTransform::scale(scale));
+
+      // Outer Ring (Brass)
+      g.setColour(juce::Colour::fromString("FFB5A642"));
+      g.drawEllipse(1.0f, 1.0f, diameter, diameter, 2.0f);
+
+      // Inner Circle (Dark)
+      g.setColour(juce::Colour::fromString("FF0F0F0F"));
+      g.fillEllipse(3.0f, 3.0f, diameter - 4.0f, diameter - 4.0f);
+    }
+    return image;
+  }
+
   juce::Typeface::Ptr metropolisTypeface;
+
+  std::map<juce::int64, juce::Image> knobBodyCache;
+
+  // Reused between knobs so drawing does not rebuild path storage
+  juce::Path pointerPath, modArcPath;
 };
 
 } // namespace daisysp_gui
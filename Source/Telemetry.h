@@ -0,0 +1,110 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// Per-block measurements taken on the audio thread for the editor.
+struct TelemetryFrame {
+  float inputPeak[2] = {0.0f, 0.0f};
+  float inputRms[2] = {0.0f, 0.0f};
+  float outputPeak[2] = {0.0f, 0.0f};
+  float outputRms[2] = {0.0f, 0.0f};
+
+  // Last LFO value of the block, after the bipolar/unipolar mapping
+  float lfo[3] = {0.0f, 0.0f, 0.0f};
+
+  // Mean square of the signal written back into the feedback loop
+  float loopEnergy = 0.0f;
+
+  // Time spent in processBlock, absolute and relative to the block duration
+  float cpuSeconds = 0.0f;
+  float cpuLoad = 0.0f;
+
+  int numSamples = 0;
+};
+
+// Single-producer/single-consumer ring carrying TelemetryFrames from the
+// audio thread to the editor. push() never blocks or allocates: when the
+// consumer falls behind (or no editor is open) frames are simply dropped.
+class TelemetryFifo {
+public:
+  // Audio thread only
+  bool push(const TelemetryFrame &frame) {
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0) {
+      droppedFrames.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    frames[(size_t)(size1 > 0 ? start1 : start2)] = frame;
+    fifo.finishedWrite(1);
+    return true;
+  }
+
+  // Message thread only. Calls fn(const TelemetryFrame &) for every pending
+  // frame, oldest first, and returns how many were consumed.
+  template <typename Fn> int drain(Fn &&fn) {
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+      fn(frames[(size_t)(start1 + i)]);
+    for (int i = 0; i < size2; ++i)
+      fn(frames[(size_t)(start2 + i)]);
+
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+  }
+
+  int getNumDroppedFrames() const {
+    return droppedFrames.load(std::memory_order_relaxed);
+  }
+
+private:
+  // ~2.7s of 512 sample blocks at 48kHz
+  static constexpr int kCapacity = 256;
+
+  juce::AbstractFifo fifo{kCapacity};
+  std::array<TelemetryFrame, kCapacity> frames;
+  std::atomic<int> droppedFrames{0};
+};
+
+// Single-producer/single-consumer stream of raw samples (scope/analyzer
+// taps). Like TelemetryFifo the audio side never blocks: whatever does not
+// fit is dropped.
+class SampleFifo {
+public:
+  // Audio thread only
+  void push(const float *samples, int numSamples) {
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    if (size1 > 0)
+      std::copy(samples, samples + size1, buffer.begin() + start1);
+    if (size2 > 0)
+      std::copy(samples + size1, samples + size1 + size2,
+                buffer.begin() + start2);
+    fifo.finishedWrite(size1 + size2);
+  }
+
+  // Consumer only. Copies up to maxSamples into dest, returns the count.
+  int pull(float *dest, int maxSamples) {
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(juce::jmin(maxSamples, fifo.getNumReady()), start1,
+                       size1, start2, size2);
+    if (size1 > 0)
+      std::copy(buffer.begin() + start1, buffer.begin() + start1 + size1,
+                dest);
+    if (size2 > 0)
+      std::copy(buffer.begin() + start2, buffer.begin() + start2 + size2,
+                dest + size1);
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+  }
+
+private:
+  static constexpr int kCapacity = 1 << 15;
+
+  juce::AbstractFifo fifo{kCapacity};
+  std::array<float, kCapacity> buffer{};
+};
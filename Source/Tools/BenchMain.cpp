@@ -0,0 +1,847 @@
+// dawdrey-bench: per-module DSP microbenchmarks.
+//
+// Every case runs its module's per-sample API over blocks of input for each
+// sample rate and block size, and reports nanoseconds per sample and samples
+// per second as JSON (stdout, or --output <file>).
+//
+//   dawdrey-bench --output before.json
+//   dawdrey-bench --filter Engine --rates 48000 --blocks 64,512
+//   dawdrey-bench --accuracy-only     (the ctest check)
+//
+// The fastmath approximations are also checked against their documented
+// error bounds ("accuracy"); the exit code is 1 if any bound is exceeded.
+//
+// Timing is the median of several repetitions, each at least --min-time
+// milliseconds long, after one warm-up repetition. Compare results from the
+// same machine only.
+
+#include "BiquadFilters.h"
+#include "DSPMath.h"
+#include "EchoDelay.h"
+#include "FeedbackSynthEngine.h"
+#include "KarplusString.h"
+#include "LowHighFilter.h"
+#include "OverdriveADAA.h"
+#include "ParallelVoices.h"
+#include "PitchShifter.h"
+#include "SVFilter.h"
+#include "SimpleLFO.h"
+#include "daisysp/DelayLine.h"
+#include "daisysp/Overdrive.h"
+#include "daisysp/ReverbSc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace infrasonic;
+
+// Keeps the optimiser from discarding benchmarked work
+volatile float benchSink = 0.0f;
+
+// A benchmarked module: prepare() at a sample rate, then run() is called on
+// consecutive blocks of (mono) input.
+struct BenchCase {
+  virtual ~BenchCase() = default;
+  virtual const char *name() const = 0;
+  virtual void prepare(float sampleRate) = 0;
+  virtual void run(const float *in, int numSamples) = 0;
+};
+
+struct KarplusCase : BenchCase {
+  const char *name() const override { return "KarplusString::Process"; }
+  void prepare(float sampleRate) override {
+    string.Init(sampleRate);
+    string.SetFreq(110.0f);
+    string.SetBrightness(0.98f);
+    string.SetDamping(0.4f);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+      acc += string.Process(in[i]);
+    benchSink = acc;
+  }
+  KarplusString string;
+};
+
+template <bool Hermite> struct DelayReadCase : BenchCase {
+  const char *name() const override {
+    return Hermite ? "DelayLine::ReadHermite" : "DelayLine::Read";
+  }
+  void prepare(float sampleRate) override {
+    line->Init();
+    delay = 0.0123f * sampleRate + 0.37f;
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      line->Write(in[i]);
+      acc += Hermite ? line->ReadHermite(delay) : line->Read(delay);
+    }
+    benchSink = acc;
+  }
+  std::unique_ptr<daisysp::DelayLine<float, 12000>> line =
+      std::make_unique<daisysp::DelayLine<float, 12000>>();
+  float delay = 1.0f;
+};
+
+struct BiquadCase : BenchCase {
+  const char *name() const override {
+    return "BiquadCascade::ProcessStereo (LPF24)";
+  }
+  void prepare(float sampleRate) override {
+    filter.Init(sampleRate);
+    filter.SetParams(2000.0f, 0.9f);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      float l = in[i], r = -in[i];
+      filter.ProcessStereo(l, r);
+      acc += l + r;
+    }
+    benchSink = acc;
+  }
+  LPF24 filter;
+};
+
+// Cutoff swept every sample, as audio-rate modulation would
+struct BiquadSweepCase : BenchCase {
+  const char *name() const override {
+    return "BiquadCascade::ProcessStereo (LPF12, swept)";
+  }
+  void prepare(float sampleRate) override {
+    filter.Init(sampleRate);
+    filter.SetQ(0.9f);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      filter.SetCutoff(2000.0f + 1500.0f * in[i]);
+      float l = in[i], r = -in[i];
+      filter.ProcessStereo(l, r);
+      acc += l + r;
+    }
+    benchSink = acc;
+  }
+  LPF12 filter;
+};
+
+template <bool Swept> struct SVFCase : BenchCase {
+  const char *name() const override {
+    return Swept ? "SVFilter::ProcessStereo (LP, swept)"
+                 : "SVFilter::ProcessStereo (LP)";
+  }
+  void prepare(float sampleRate) override {
+    filter.Init(sampleRate);
+    filter.SetQ(0.9f);
+    filter.SetCutoff(2000.0f, true);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      if (Swept)
+        filter.SetCutoff(2000.0f + 1500.0f * in[i], true);
+      float l = in[i], r = -in[i];
+      filter.ProcessStereo(l, r);
+      acc += l + r;
+    }
+    benchSink = acc;
+  }
+  LowPassSVF filter;
+};
+
+// Separate stereo lowpass and highpass, the baseline for LowHighFilter
+struct SVFPairCase : BenchCase {
+  const char *name() const override {
+    return "SVFilter::ProcessStereo (LP + HP)";
+  }
+  void prepare(float sampleRate) override {
+    lpf.Init(sampleRate);
+    lpf.SetQ(0.9f);
+    lpf.SetCutoff(2000.0f, true);
+    hpf.Init(sampleRate);
+    hpf.SetQ(0.9f);
+    hpf.SetCutoff(60.0f, true);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      float l = in[i], r = -in[i];
+      lpf.ProcessStereo(l, r);
+      hpf.ProcessStereo(l, r);
+      acc += l + r;
+    }
+    benchSink = acc;
+  }
+  LowPassSVF lpf;
+  HighPassSVF hpf;
+};
+
+template <LowHighFilter::Slope Slope> struct LowHighFilterCase : BenchCase {
+  const char *name() const override {
+    switch (Slope) {
+    case LowHighFilter::Slope::Slope12:
+      return "LowHighFilter::ProcessStereo (12 dB)";
+    case LowHighFilter::Slope::Slope24:
+      return "LowHighFilter::ProcessStereo (24 dB)";
+    default:
+      return "LowHighFilter::ProcessStereo (36 dB)";
+    }
+  }
+  void prepare(float sampleRate) override {
+    filter.Init(sampleRate);
+    filter.SetSlope(Slope);
+    filter.SetQ(0.9f);
+    filter.SetLowPassCutoff(2000.0f, true);
+    filter.SetHighPassCutoff(60.0f, true);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      float l = in[i], r = -in[i];
+      filter.ProcessStereo(l, r);
+      acc += l + r;
+    }
+    benchSink = acc;
+  }
+  LowHighFilter filter;
+};
+
+struct ReverbCase : BenchCase {
+  const char *name() const override { return "ReverbSc::Process"; }
+  void prepare(float sampleRate) override {
+    verb->Init(sampleRate);
+    verb->SetFeedback(0.85f);
+    verb->SetLpFreq(18000.0f);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      float l, r;
+      verb->Process(in[i], in[i], &l, &r);
+      acc += l + r;
+    }
+    benchSink = acc;
+  }
+  std::unique_ptr<daisysp::ReverbSc> verb =
+      std::make_unique<daisysp::ReverbSc>();
+};
+
+struct EchoCase : BenchCase {
+  static constexpr size_t kMaxLength = 48000 * 5;
+  const char *name() const override { return "EchoDelay::Process"; }
+  void prepare(float sampleRate) override {
+    echo->Init(sampleRate);
+    echo->SetDelayTime(0.5f, true);
+    echo->SetFeedback(0.5f);
+    echo->SetLagTime(0.5f);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      float l, r;
+      echo->Process(in[i], in[i], l, r);
+      acc += l + r;
+    }
+    benchSink = acc;
+  }
+  std::unique_ptr<EchoDelay<kMaxLength>> echo =
+      std::make_unique<EchoDelay<kMaxLength>>();
+};
+
+// Same echo a block at a time, with one head or four heads and ping-pong
+template <size_t NumTaps> struct EchoBlockCase : EchoCase {
+  const char *name() const override {
+    return NumTaps == 1 ? "EchoDelay::ProcessBlock"
+                        : "EchoDelay::ProcessBlock (4 taps, ping-pong)";
+  }
+  void prepare(float sampleRate) override {
+    EchoCase::prepare(sampleRate);
+    echo->SetNumTaps(NumTaps);
+    for (size_t t = 0; t < NumTaps; t++)
+      echo->SetTap(t, (float)(t + 1) / (float)NumTaps, 1.0f / (float)NumTaps);
+    echo->SetPingPong(NumTaps > 1);
+  }
+  void run(const float *in, int numSamples) override {
+    if (outL.size() < (size_t)numSamples) {
+      outL.resize((size_t)numSamples);
+      outR.resize((size_t)numSamples);
+    }
+    echo->ProcessBlock(in, in, outL.data(), outR.data(), (size_t)numSamples);
+    benchSink = outL[(size_t)numSamples - 1] + outR[(size_t)numSamples - 1];
+  }
+  std::vector<float> outL, outR;
+};
+
+// One-head block echo with its lines kept in a 16-bit format
+template <SampleFormat Format> struct EchoStorageCase : BenchCase {
+  const char *name() const override {
+    return Format == SampleFormat::Int16 ? "EchoDelay::ProcessBlock (int16)"
+                                         : "EchoDelay::ProcessBlock (half)";
+  }
+  void prepare(float sampleRate) override {
+    echo->Init(sampleRate);
+    echo->SetDelayTime(0.5f, true);
+    echo->SetFeedback(0.5f);
+    echo->SetLagTime(0.5f);
+  }
+  void run(const float *in, int numSamples) override {
+    if (outL.size() < (size_t)numSamples) {
+      outL.resize((size_t)numSamples);
+      outR.resize((size_t)numSamples);
+    }
+    echo->ProcessBlock(in, in, outL.data(), outR.data(), (size_t)numSamples);
+    benchSink = outL[(size_t)numSamples - 1] + outR[(size_t)numSamples - 1];
+  }
+  std::unique_ptr<EchoDelay<EchoCase::kMaxLength, Format>> echo =
+      std::make_unique<EchoDelay<EchoCase::kMaxLength, Format>>();
+  std::vector<float> outL, outR;
+};
+
+struct PitchShifterCase : BenchCase {
+  const char *name() const override { return "PitchShifter::Process"; }
+  void prepare(float sampleRate) override {
+    shifter.Init(sampleRate);
+    shifter.SetShift(7.0f);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+      acc += shifter.Process(in[i]);
+    benchSink = acc;
+  }
+  PitchShifter shifter;
+};
+
+struct OverdriveCase : BenchCase {
+  const char *name() const override { return "Overdrive::Process"; }
+  void prepare(float) override {
+    drive.Init();
+    drive.SetDrive(0.4f);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+      acc += drive.Process(in[i]);
+    benchSink = acc;
+  }
+  daisysp::Overdrive drive;
+};
+
+struct OverdriveADAACase : BenchCase {
+  const char *name() const override { return "OverdriveADAA::ProcessBlock"; }
+  void prepare(float) override {
+    drive.Init();
+    drive.SetDrive(0.4f);
+  }
+  void run(const float *in, int numSamples) override {
+    if (scratch.size() < (size_t)numSamples)
+      scratch.resize((size_t)numSamples);
+    std::copy(in, in + numSamples, scratch.data());
+    drive.ProcessBlock(scratch.data(), (size_t)numSamples);
+    benchSink = scratch[(size_t)numSamples - 1];
+  }
+  OverdriveADAA drive;
+  std::vector<float> scratch;
+};
+
+struct LFOCase : BenchCase {
+  const char *name() const override { return "SimpleLFO::Process"; }
+  void prepare(float sampleRate) override {
+    lfo.Init(sampleRate);
+    lfo.SetRate(3.0f);
+    lfo.SetWaveform(daisysp::SimpleLFO::WAVE_SINE);
+  }
+  void run(const float *, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+      acc += lfo.Process();
+    benchSink = acc;
+  }
+  daisysp::SimpleLFO lfo;
+};
+
+// Transcendental functions from libm, fastmath per sample and fastmath four
+// lanes at a time, on arguments spread over each function's usual range
+enum class MathImpl { Libm, Fast, Fast4 };
+
+#define DAWDREY_MATH_FN(Type, fn, libmFn, scale, offset)                       \
+  struct Type {                                                                \
+    static constexpr const char *kName = #fn;                                  \
+    static constexpr float kScale = scale, kOffset = offset;                   \
+    static float libm(float x) { return libmFn; }                              \
+    template <typename T> static T fast(T x) { return fastmath::fn(x); }       \
+  };
+
+DAWDREY_MATH_FN(Exp2Fn, exp2, std::exp2(x), 100.0f, 0.0f)
+DAWDREY_MATH_FN(Log2Fn, log2, std::log2(x), 10.0f, 1.5f)
+DAWDREY_MATH_FN(SinFn, sin, std::sin(x), 30.0f, 0.0f)
+DAWDREY_MATH_FN(CosFn, cos, std::cos(x), 30.0f, 0.0f)
+DAWDREY_MATH_FN(TanFn, tan, std::tan(x), 5.0f, 0.75f)
+DAWDREY_MATH_FN(TanhFn, tanh, std::tanh(x), 20.0f, 0.0f)
+DAWDREY_MATH_FN(MtofFn, mtof, 440.0f * std::pow(2.0f, (x - 69.0f) / 12.0f),
+                200.0f, 60.0f)
+DAWDREY_MATH_FN(Db2LinFn, db2lin, std::pow(10.0f, x * 0.05f), 600.0f, -30.0f)
+
+#undef DAWDREY_MATH_FN
+
+template <typename Fn, MathImpl Impl> struct MathCase : BenchCase {
+  MathCase()
+      : label(std::string(Impl == MathImpl::Libm ? "libm::" : "fastmath::") +
+              Fn::kName + (Impl == MathImpl::Fast4 ? " (float4)" : "")) {}
+  const char *name() const override { return label.c_str(); }
+  void prepare(float) override {}
+  void run(const float *in, int numSamples) override {
+    int i = 0;
+    float acc = 0.0f;
+    if constexpr (Impl == MathImpl::Fast4) {
+      const auto scale = simd::set1(Fn::kScale);
+      const auto offset = simd::set1(Fn::kOffset);
+      auto acc4 = simd::set1(0.0f);
+      for (; i + 4 <= numSamples; i += 4)
+        acc4 = acc4 + Fn::fast(simd::load(in + i) * scale + offset);
+      for (int k = 0; k < 4; ++k)
+        acc += simd::lane(acc4, k);
+    }
+    for (; i < numSamples; ++i) {
+      const float x = in[i] * Fn::kScale + Fn::kOffset;
+      acc += Impl == MathImpl::Libm ? Fn::libm(x) : Fn::fast(x);
+    }
+    benchSink = acc;
+  }
+  std::string label;
+};
+
+template <typename Fn> void addMathCases(auto &cases) {
+  cases.push_back(std::make_unique<MathCase<Fn, MathImpl::Libm>>());
+  cases.push_back(std::make_unique<MathCase<Fn, MathImpl::Fast>>());
+  cases.push_back(std::make_unique<MathCase<Fn, MathImpl::Fast4>>());
+}
+
+// The error bounds documented in DSPMath.h, measured against double
+// precision libm over each function's domain
+struct AccuracyCheck {
+  enum Metric { Absolute, Relative, Mixed }; // Mixed: relative above 1
+  const char *name;
+  double lo, hi;
+  bool logSpaced;
+  Metric metric;
+  double bound;
+  double (*reference)(double);
+  float (*fast)(float);
+  simd::float4 (*fast4)(simd::float4);
+};
+
+#define DAWDREY_ACCURACY(fn, lo, hi, logSpaced, metric, bound, reference)     \
+  AccuracyCheck {                                                              \
+    #fn, lo, hi, logSpaced, AccuracyCheck::metric, bound,                      \
+        [](double x) -> double { return reference; }, &fastmath::fn<float>,    \
+        &fastmath::fn<simd::float4>                                            \
+  }
+
+const AccuracyCheck kAccuracyChecks[] = {
+    DAWDREY_ACCURACY(exp2, -126.0, 127.0, false, Relative, 2e-7, std::exp2(x)),
+    DAWDREY_ACCURACY(exp, -87.0, 88.0, false, Relative, 3e-7, std::exp(x)),
+    DAWDREY_ACCURACY(log2, 1.18e-38, 3.4e38, true, Mixed, 2e-7, std::log2(x)),
+    DAWDREY_ACCURACY(sin, -M_PI, M_PI, false, Absolute, 5e-7, std::sin(x)),
+    DAWDREY_ACCURACY(cos, -M_PI, M_PI, false, Absolute, 2e-7, std::cos(x)),
+    DAWDREY_ACCURACY(tan, -1.55, 1.55, false, Relative, 3e-6, std::tan(x)),
+    DAWDREY_ACCURACY(tanh, -20.0, 20.0, false, Absolute, 5e-7, std::tanh(x)),
+    DAWDREY_ACCURACY(mtof, -24.0, 160.0, false, Relative, 1e-6,
+                     440.0 * std::exp2((x - 69.0) / 12.0)),
+    DAWDREY_ACCURACY(db2lin, -120.0, 120.0, false, Relative, 1e-6,
+                     std::pow(10.0, x / 20.0)),
+    DAWDREY_ACCURACY(lin2db, 1.18e-38, 3.4e38, true, Mixed, 3e-7,
+                     20.0 * std::log10(x)),
+};
+
+#undef DAWDREY_ACCURACY
+
+// Writes the "accuracy" JSON array; false if any bound is exceeded
+bool checkAccuracy(FILE *out) {
+  constexpr int kPoints = 1 << 20;
+  bool allPassed = true;
+
+  std::fprintf(out, "  \"accuracy\": [");
+  for (const auto &check : kAccuracyChecks) {
+    double maxError = 0.0, maxErrorSimd = 0.0;
+    for (int i = 0; i <= kPoints; ++i) {
+      const double t = (double)i / kPoints;
+      const float x =
+          check.logSpaced
+              ? (float)std::exp(std::log(check.lo) +
+                                t * (std::log(check.hi) - std::log(check.lo)))
+              : (float)(check.lo + t * (check.hi - check.lo));
+      const double ref = check.reference((double)x);
+      const double scale = check.metric == AccuracyCheck::Absolute ? 1.0
+                           : check.metric == AccuracyCheck::Relative
+                               ? std::fabs(ref)
+                               : std::max(1.0, std::fabs(ref));
+      const double lane = simd::lane(check.fast4(simd::set1(x)), 0);
+      maxError = std::max(maxError, std::fabs(check.fast(x) - ref) / scale);
+      maxErrorSimd = std::max(maxErrorSimd, std::fabs(lane - ref) / scale);
+    }
+
+    const bool passed = maxError <= check.bound && maxErrorSimd <= check.bound;
+    allPassed = allPassed && passed;
+    std::fprintf(out,
+                 "%s\n    {\"function\": \"%s\", \"max_error\": %.3g, "
+                 "\"max_error_simd\": %.3g, \"bound\": %.3g, \"pass\": %s}",
+                 &check == kAccuracyChecks ? "" : ",", check.name, maxError,
+                 maxErrorSimd, check.bound, passed ? "true" : "false");
+  }
+  std::fprintf(out, "\n  ],\n");
+  return allPassed;
+}
+
+// Every stage doing work (echo, reverb, pitch shifter)
+void configureEngine(FeedbackSynth::Engine &engine, float sampleRate) {
+  engine.Init(sampleRate);
+  engine.SetStringPitch(40.0f);
+  engine.SetFeedbackGain(-6.0f);
+  engine.SetFeedbackDelay(0.064f);
+  engine.SetFeedbackLPFCutoff(18000.0f);
+  engine.SetFeedbackHPFCutoff(60.0f);
+  engine.SetEchoDelaySendAmount(0.3f);
+  engine.SetEchoDelayTime(0.5f);
+  engine.SetEchoDelayFeedback(0.5f);
+  engine.SetReverbMix(0.3f);
+  engine.SetReverbFeedback(0.85f);
+  engine.pitchEnabled = true;
+  engine.pitchShift = 7.0f;
+}
+
+struct EngineCase : BenchCase {
+  const char *name() const override { return "Engine::Process"; }
+  void prepare(float sampleRate) override {
+    configureEngine(*engine, sampleRate);
+  }
+  void run(const float *in, int numSamples) override {
+    float acc = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      float l, r;
+      engine->Process(in[i], l, r);
+      acc += l + r;
+    }
+    benchSink = acc;
+  }
+  std::unique_ptr<FeedbackSynth::Engine> engine =
+      std::make_unique<FeedbackSynth::Engine>();
+};
+
+// Same patch through the chunked block path
+struct EngineBlockCase : EngineCase {
+  const char *name() const override { return "Engine::ProcessBlock"; }
+  void run(const float *in, int numSamples) override {
+    if (outL.size() < (size_t)numSamples) {
+      outL.resize((size_t)numSamples);
+      outR.resize((size_t)numSamples);
+    }
+    engine->ProcessBlock(in, outL.data(), outR.data(), (size_t)numSamples);
+    benchSink = outL[(size_t)numSamples - 1] + outR[(size_t)numSamples - 1];
+  }
+  std::vector<float> outL, outR;
+};
+
+// Same patch with the steepest loop filters
+struct EngineSlope36Case : EngineCase {
+  const char *name() const override {
+    return "Engine::Process (36 dB loop filters)";
+  }
+  void prepare(float sampleRate) override {
+    EngineCase::prepare(sampleRate);
+    engine->SetFeedbackFilterSlope(LowHighFilter::Slope::Slope36);
+  }
+};
+
+RealtimeWorkerPool &workerPool() {
+  static RealtimeWorkerPool pool;
+  return pool;
+}
+
+// Eight full engines at different pitches summed into one output, rendered
+// one after another or spread over the worker pool. ns/sample is per output
+// sample, so it covers all eight voices.
+template <bool Pooled> struct VoicesCase : BenchCase {
+  static constexpr size_t kNumVoices = 8;
+  static constexpr size_t kMaxBlock = 4096;
+
+  const char *name() const override {
+    return Pooled ? "ParallelVoices x8 (pool)" : "ParallelVoices x8 (serial)";
+  }
+  void prepare(float sampleRate) override {
+    for (size_t v = 0; v < kNumVoices; ++v) {
+      if (engines[v] == nullptr)
+        engines[v] = std::make_unique<FeedbackSynth::Engine>();
+      configureEngine(*engines[v], sampleRate);
+      engines[v]->SetStringPitch(40.0f + 3.0f * (float)v);
+      voicePtrs[v] = engines[v].get();
+    }
+    voices.Prepare(kNumVoices, kMaxBlock);
+    voices.SetPool(Pooled ? &workerPool() : nullptr);
+  }
+  void run(const float *in, int numSamples) override {
+    // Blocks above kMaxBlock are chunked by the voices, not by the caller
+    if (outL.size() < (size_t)numSamples) {
+      outL.resize((size_t)numSamples);
+      outR.resize((size_t)numSamples);
+    }
+    voices.Process(voicePtrs, kNumVoices, in, outL.data(), outR.data(),
+                   (size_t)numSamples);
+    benchSink = outL[0] + outR[(size_t)numSamples - 1];
+  }
+  std::unique_ptr<FeedbackSynth::Engine> engines[kNumVoices];
+  FeedbackSynth::Engine *voicePtrs[kNumVoices] = {};
+  ParallelVoices<FeedbackSynth::Engine> voices;
+  std::vector<float> outL, outR;
+};
+
+struct Options {
+  std::vector<int> sampleRates{44100, 48000, 96000, 192000};
+  std::vector<int> blockSizes{16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+  std::string filter;
+  std::string outputPath;
+  double minTimeMs = 20.0;
+  int repetitions = 5;
+  bool accuracyOnly = false;
+};
+
+std::vector<int> parseList(const char *text) {
+  std::vector<int> values;
+  for (const char *p = text; *p != '\0';) {
+    char *end = nullptr;
+    const long value = std::strtol(p, &end, 10);
+    if (end == p)
+      break;
+    if (value > 0)
+      values.push_back((int)value);
+    p = (*end == ',') ? end + 1 : end;
+  }
+  return values;
+}
+
+void printUsage() {
+  std::printf(
+      "Usage: dawdrey-bench [options]\n\n"
+      "  --output <file>     Write JSON to a file instead of stdout\n"
+      "  --filter <text>     Only run cases whose name contains text\n"
+      "  --rates <list>      Comma separated sample rates\n"
+      "  --blocks <list>     Comma separated block sizes\n"
+      "  --min-time <ms>     Minimum duration of one repetition (default 20)\n"
+      "  --repetitions <n>   Timed repetitions per point (default 5)\n"
+      "  --accuracy-only     Only check the fastmath error bounds\n");
+}
+
+const char *simdName() {
+#if defined(INFS_SIMD_SSE)
+  return "sse2";
+#elif defined(INFS_SIMD_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+std::string compilerName() {
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_VER);
+#else
+  return "unknown";
+#endif
+}
+
+// Nanoseconds per sample for one (case, rate, block) point
+double measure(BenchCase &bench, const std::vector<float> &input,
+               int blockSize, const Options &options) {
+  using Clock = std::chrono::steady_clock;
+  const size_t inputLength = input.size() - (size_t)blockSize;
+
+  auto runFor = [&](double minMs) {
+    size_t offset = 0;
+    long long samples = 0;
+    const auto start = Clock::now();
+    double elapsedMs = 0.0;
+    do {
+      // Blocks per clock read, so short blocks are not dominated by now()
+      for (int k = 0; k < 16; ++k) {
+        bench.run(input.data() + offset, blockSize);
+        offset = (offset + (size_t)blockSize) % inputLength;
+        samples += blockSize;
+      }
+      elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() -
+                                                            start)
+                      .count();
+    } while (elapsedMs < minMs);
+    return elapsedMs * 1.0e6 / (double)samples;
+  };
+
+  runFor(options.minTimeMs * 0.5); // Warm caches and branch predictors
+
+  std::vector<double> results;
+  for (int r = 0; r < options.repetitions; ++r)
+    results.push_back(runFor(options.minTimeMs));
+
+  std::sort(results.begin(), results.end());
+  return results[results.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    const bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--output") == 0 && hasValue)
+      options.outputPath = argv[++i];
+    else if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+      options.filter = argv[++i];
+    else if (std::strcmp(argv[i], "--rates") == 0 && hasValue)
+      options.sampleRates = parseList(argv[++i]);
+    else if (std::strcmp(argv[i], "--blocks") == 0 && hasValue)
+      options.blockSizes = parseList(argv[++i]);
+    else if (std::strcmp(argv[i], "--min-time") == 0 && hasValue)
+      options.minTimeMs = std::atof(argv[++i]);
+    else if (std::strcmp(argv[i], "--repetitions") == 0 && hasValue)
+      options.repetitions = std::max(1, std::atoi(argv[++i]));
+    else if (std::strcmp(argv[i], "--accuracy-only") == 0)
+      options.accuracyOnly = true;
+    else {
+      printUsage();
+      return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+    }
+  }
+
+  if (options.sampleRates.empty() || options.blockSizes.empty()) {
+    std::fprintf(stderr,
+                 "--rates and --blocks need at least one positive value\n\n");
+    printUsage();
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<BenchCase>> cases;
+  cases.push_back(std::make_unique<KarplusCase>());
+  cases.push_back(std::make_unique<DelayReadCase<false>>());
+  cases.push_back(std::make_unique<DelayReadCase<true>>());
+  cases.push_back(std::make_unique<BiquadCase>());
+  cases.push_back(std::make_unique<BiquadSweepCase>());
+  cases.push_back(std::make_unique<SVFCase<false>>());
+  cases.push_back(std::make_unique<SVFCase<true>>());
+  cases.push_back(std::make_unique<SVFPairCase>());
+  cases.push_back(
+      std::make_unique<LowHighFilterCase<LowHighFilter::Slope::Slope12>>());
+  cases.push_back(
+      std::make_unique<LowHighFilterCase<LowHighFilter::Slope::Slope24>>());
+  cases.push_back(
+      std::make_unique<LowHighFilterCase<LowHighFilter::Slope::Slope36>>());
+  cases.push_back(std::make_unique<ReverbCase>());
+  cases.push_back(std::make_unique<EchoCase>());
+  cases.push_back(std::make_unique<EchoBlockCase<1>>());
+  cases.push_back(std::make_unique<EchoBlockCase<4>>());
+  cases.push_back(std::make_unique<EchoStorageCase<SampleFormat::Int16>>());
+  cases.push_back(std::make_unique<EchoStorageCase<SampleFormat::Float16>>());
+  cases.push_back(std::make_unique<PitchShifterCase>());
+  cases.push_back(std::make_unique<OverdriveCase>());
+  cases.push_back(std::make_unique<OverdriveADAACase>());
+  cases.push_back(std::make_unique<LFOCase>());
+  cases.push_back(std::make_unique<EngineCase>());
+  cases.push_back(std::make_unique<EngineBlockCase>());
+  cases.push_back(std::make_unique<EngineSlope36Case>());
+  cases.push_back(std::make_unique<VoicesCase<false>>());
+  cases.push_back(std::make_unique<VoicesCase<true>>());
+  addMathCases<Exp2Fn>(cases);
+  addMathCases<Log2Fn>(cases);
+  addMathCases<SinFn>(cases);
+  addMathCases<CosFn>(cases);
+  addMathCases<TanFn>(cases);
+  addMathCases<TanhFn>(cases);
+  addMathCases<MtofFn>(cases);
+  addMathCases<Db2LinFn>(cases);
+
+  // Low level noise with a few transients, long enough that every block
+  // size walks through different data
+  const int maxBlock =
+      *std::max_element(options.blockSizes.begin(), options.blockSizes.end());
+  std::vector<float> input((size_t)(1 << 16) + (size_t)maxBlock);
+  uint32_t seed = 0x1234567u;
+  for (size_t i = 0; i < input.size(); ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    input[i] = ((float)(seed >> 8) / 16777216.0f - 0.5f) * 0.2f;
+    if (i % 4096 == 0)
+      input[i] = 0.9f;
+  }
+
+  FILE *out = options.outputPath.empty()
+                  ? stdout
+                  : std::fopen(options.outputPath.c_str(), "w");
+  if (out == nullptr) {
+    std::fprintf(stderr, "Cannot write %s\n", options.outputPath.c_str());
+    return 1;
+  }
+
+  std::fprintf(out,
+               "{\n  \"build\": {\"compiler\": \"%s\", \"simd\": \"%s\", "
+               "\"debug\": %s},\n",
+               compilerName().c_str(), simdName(),
+#ifdef NDEBUG
+               "false"
+#else
+               "true"
+#endif
+  );
+  const bool accurate = checkAccuracy(out);
+  std::fprintf(out, "  \"results\": [");
+
+  bool first = true;
+  for (auto &bench : cases) {
+    if (options.accuracyOnly)
+      break;
+    if (!options.filter.empty() &&
+        std::string(bench->name()).find(options.filter) == std::string::npos)
+      continue;
+
+    for (const int sampleRate : options.sampleRates) {
+      bench->prepare((float)sampleRate);
+
+      for (const int blockSize : options.blockSizes) {
+        const double nsPerSample =
+            measure(*bench, input, blockSize, options);
+        const double samplesPerSecond = 1.0e9 / nsPerSample;
+
+        std::fprintf(out,
+                     "%s\n    {\"module\": \"%s\", \"sample_rate\": %d, "
+                     "\"block_size\": %d, \"ns_per_sample\": %.3f, "
+                     "\"samples_per_second\": %.0f, \"realtime_load\": %.6f}",
+                     first ? "" : ",", bench->name(), sampleRate, blockSize,
+                     nsPerSample, samplesPerSecond,
+                     (double)sampleRate / samplesPerSecond);
+        std::fflush(out);
+        first = false;
+      }
+    }
+  }
+
+  std::fprintf(out, "\n  ]\n}\n");
+  if (out != stdout)
+    std::fclose(out);
+
+  if (!accurate) {
+    std::fprintf(stderr, "fastmath error bounds exceeded (see accuracy)\n");
+    return 1;
+  }
+  return 0;
+}
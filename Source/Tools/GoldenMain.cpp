@@ -0,0 +1,417 @@
+// dawdrey-golden: golden-output regression harness.
+//
+// Renders deterministic excitations (impulse, noise burst, sine sweep)
+// through DawdreyAudioProcessor for the init patch and every factory preset,
+// at several sample rates and block sizes, and either records the results
+// as reference files or compares against previously recorded ones:
+//
+//   dawdrey-golden record refs/     (on the known-good build)
+//   dawdrey-golden verify refs/     (after the change, same machine)
+//
+// Each render keeps two stages: the plugin output and the signal written
+// back into the feedback loop. A stage passes when it is bit-exact. When it
+// is not, the tolerance model applies: the onset (before the chaotic loop
+// has had time to diverge) must still match sample by sample, and the rest
+// must stay within a log-spectral distance and an RMS level difference.
+// --exact disables the fallback for refactors that must not change a bit.
+//
+// References depend on compiler, flags and CPU. Record and verify with the
+// same build configuration on the same machine.
+
+#include "PluginProcessor.h"
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+enum class Excitation { Impulse, NoiseBurst, SineSweep };
+
+const char *getExcitationName(Excitation excitation) {
+  switch (excitation) {
+  case Excitation::Impulse:
+    return "impulse";
+  case Excitation::NoiseBurst:
+    return "noise";
+  case Excitation::SineSweep:
+    return "sweep";
+  }
+  return "";
+}
+
+struct Case {
+  juce::String presetName; // "Init" or a factory preset
+  Excitation excitation;
+  double sampleRate;
+  int blockSize;
+
+  juce::String getDescription() const {
+    return presetName + " / " + getExcitationName(excitation) + " / " +
+           juce::String((int)sampleRate) + " / " + juce::String(blockSize);
+  }
+
+  juce::String getFileName() const {
+    return presetName.replace(" - ", "_").replaceCharacter(' ', '_') + "__" +
+           getExcitationName(excitation) + "__" +
+           juce::String((int)sampleRate) + "__" + juce::String(blockSize) +
+           ".wav";
+  }
+};
+
+struct StageTolerance {
+  double onsetMs = 10.0;    // Compared sample by sample
+  float onsetMaxAbs = 0.0f; // 0 = bit exact
+  double spectralDb = 3.0;  // Mean log-spectral distance after the onset
+  double levelDb = 1.0;     // RMS level difference after the onset
+};
+
+struct Options {
+  juce::Array<double> sampleRates{44100.0, 48000.0, 96000.0};
+  juce::Array<int> blockSizes{64, 512};
+  double seconds = 2.0;
+  bool exactOnly = false;
+  juce::String filter;
+  int numThreads = 0;
+  StageTolerance tolerance;
+};
+
+// Stateless integer hash, so the noise does not depend on block boundaries
+float noiseAt(juce::int64 index) {
+  auto x = (juce::uint32)(index * 0x9E3779B1u);
+  x ^= x >> 16;
+  x *= 0x85EBCA6Bu;
+  x ^= x >> 13;
+  x *= 0xC2B2AE35u;
+  x ^= x >> 16;
+  return (float)(x >> 8) / 16777216.0f * 2.0f - 1.0f;
+}
+
+float excitationAt(Excitation excitation, juce::int64 index,
+                   double sampleRate) {
+  const double t = (double)index / sampleRate;
+  switch (excitation) {
+  case Excitation::Impulse:
+    return index == 0 ? 1.0f : 0.0f;
+  case Excitation::NoiseBurst:
+    return t < 0.05 ? 0.5f * noiseAt(index) : 0.0f;
+  case Excitation::SineSweep: {
+    // Exponential sweep 20 Hz to 20 kHz (or 0.45 fs) over one second
+    const double duration = 1.0;
+    if (t >= duration)
+      return 0.0f;
+    const double f0 = 20.0;
+    const double f1 = juce::jmin(20000.0, 0.45 * sampleRate);
+    const double k = std::log(f1 / f0);
+    const double phase = juce::MathConstants<double>::twoPi * f0 * duration /
+                         k * (std::exp(t / duration * k) - 1.0);
+    return 0.5f * (float)std::sin(phase);
+  }
+  }
+  return 0.0f;
+}
+
+// Channels 0/1: output, channel 2: feedback loop
+juce::AudioBuffer<float> renderCase(const Case &c, const Options &options) {
+  const int length = (int)(options.seconds * c.sampleRate);
+  juce::AudioBuffer<float> result(3, length);
+  result.clear();
+
+  DawdreyAudioProcessor processor;
+  processor.presetManager->loadInitPreset();
+  for (const auto &preset : getFactoryPresets())
+    if (c.presetName == preset.name)
+      processor.presetManager->applyFactoryPreset(preset);
+
+  processor.setNonRealtime(true);
+  processor.setRateAndBufferSizeDetails(c.sampleRate, c.blockSize);
+  processor.prepareToPlay(c.sampleRate, c.blockSize);
+  processor.analyzerTapsLoop.store(true);
+  processor.analyzerActive.store(true);
+
+  juce::AudioBuffer<float> buffer(2, c.blockSize);
+  juce::MidiBuffer midi;
+
+  for (int pos = 0; pos < length; pos += c.blockSize) {
+    const int numSamples = juce::jmin(c.blockSize, length - pos);
+    juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2,
+                                   numSamples);
+
+    for (int i = 0; i < numSamples; ++i) {
+      const float x = excitationAt(c.excitation, pos + i, c.sampleRate);
+      block.setSample(0, i, x);
+      block.setSample(1, i, x);
+    }
+
+    processor.processBlock(block, midi);
+
+    result.copyFrom(0, pos, block, 0, 0, numSamples);
+    result.copyFrom(1, pos, block, 1, 0, numSamples);
+    processor.analyzerFifo.pull(result.getWritePointer(2, pos), numSamples);
+  }
+
+  processor.releaseResources();
+  return result;
+}
+
+struct StageResult {
+  bool exact = false;
+  bool pass = false;
+  juce::String detail;
+};
+
+double rmsDb(const float *x, int n) {
+  double sum = 0.0;
+  for (int i = 0; i < n; ++i)
+    sum += (double)x[i] * x[i];
+  return juce::Decibels::gainToDecibels(std::sqrt(sum / juce::jmax(1, n)),
+                                        -200.0);
+}
+
+// Mean over frames of the RMS dB difference between magnitude spectra,
+// ignoring bins where both signals sit below the noise floor
+double spectralDistanceDb(const float *a, const float *b, int n) {
+  constexpr int kOrder = 11;
+  constexpr int kSize = 1 << kOrder;
+  constexpr float kFloorDb = -100.0f;
+
+  juce::dsp::FFT fft(kOrder);
+  juce::dsp::WindowingFunction<float> window(
+      (size_t)kSize, juce::dsp::WindowingFunction<float>::hann, false);
+  std::vector<float> fa((size_t)kSize * 2), fb((size_t)kSize * 2);
+
+  double total = 0.0;
+  int frames = 0;
+  for (int start = 0; start + kSize <= n; start += kSize / 2) {
+    std::fill(fa.begin(), fa.end(), 0.0f);
+    std::fill(fb.begin(), fb.end(), 0.0f);
+    std::copy(a + start, a + start + kSize, fa.begin());
+    std::copy(b + start, b + start + kSize, fb.begin());
+    window.multiplyWithWindowingTable(fa.data(), (size_t)kSize);
+    window.multiplyWithWindowingTable(fb.data(), (size_t)kSize);
+    fft.performFrequencyOnlyForwardTransform(fa.data(), true);
+    fft.performFrequencyOnlyForwardTransform(fb.data(), true);
+
+    double sum = 0.0;
+    int bins = 0;
+    for (int k = 1; k < kSize / 2; ++k) {
+      const float da = juce::Decibels::gainToDecibels(
+          fa[(size_t)k] * 4.0f / kSize, kFloorDb);
+      const float db = juce::Decibels::gainToDecibels(
+          fb[(size_t)k] * 4.0f / kSize, kFloorDb);
+      if (da <= kFloorDb && db <= kFloorDb)
+        continue;
+      sum += (double)(da - db) * (da - db);
+      ++bins;
+    }
+
+    if (bins > 0) {
+      total += std::sqrt(sum / bins);
+      ++frames;
+    }
+  }
+  return frames > 0 ? total / frames : 0.0;
+}
+
+StageResult compareStage(const juce::AudioBuffer<float> &ref,
+                         const juce::AudioBuffer<float> &out,
+                         std::initializer_list<int> channels,
+                         double sampleRate, const Options &options) {
+  StageResult result;
+  const int length = juce::jmin(ref.getNumSamples(), out.getNumSamples());
+  const auto &tol = options.tolerance;
+
+  if (ref.getNumSamples() != out.getNumSamples()) {
+    result.detail = "length differs";
+    return result;
+  }
+
+  result.exact = true;
+  for (const int ch : channels)
+    result.exact =
+        result.exact && std::memcmp(ref.getReadPointer(ch),
+                                    out.getReadPointer(ch),
+                                    sizeof(float) * (size_t)length) == 0;
+  if (result.exact || options.exactOnly) {
+    result.pass = result.exact;
+    result.detail = result.exact ? "exact" : "not bit-exact";
+    return result;
+  }
+
+  const int onset =
+      juce::jmin(length, (int)(tol.onsetMs * 0.001 * sampleRate));
+  float onsetError = 0.0f;
+  double worstSpectral = 0.0, worstLevel = 0.0;
+
+  for (const int ch : channels) {
+    const float *r = ref.getReadPointer(ch);
+    const float *o = out.getReadPointer(ch);
+    for (int i = 0; i < onset; ++i)
+      onsetError = juce::jmax(onsetError, std::abs(r[i] - o[i]));
+
+    worstSpectral =
+        juce::jmax(worstSpectral,
+                   spectralDistanceDb(r + onset, o + onset, length - onset));
+    worstLevel = juce::jmax(worstLevel,
+                            std::abs(rmsDb(r + onset, length - onset) -
+                                     rmsDb(o + onset, length - onset)));
+  }
+
+  result.pass = onsetError <= tol.onsetMaxAbs &&
+                worstSpectral <= tol.spectralDb && worstLevel <= tol.levelDb;
+  result.detail = "onset " + juce::String(onsetError, 7) + ", spectral " +
+                  juce::String(worstSpectral, 2) + " dB, level " +
+                  juce::String(worstLevel, 2) + " dB";
+  return result;
+}
+
+bool writeReference(const juce::File &file,
+                    const juce::AudioBuffer<float> &data, double sampleRate) {
+  file.deleteFile();
+  std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+  if (stream == nullptr)
+    return false;
+
+  // 32 bit WAV is IEEE float, so references round-trip bit for bit
+  juce::WavAudioFormat wav;
+  std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(
+      stream.get(), sampleRate, (unsigned int)data.getNumChannels(), 32, {},
+      0));
+  if (writer == nullptr)
+    return false;
+  stream.release();
+
+  return writer->writeFromAudioSampleBuffer(data, 0, data.getNumSamples());
+}
+
+bool readReference(const juce::File &file, juce::AudioBuffer<float> &data) {
+  juce::WavAudioFormat wav;
+  std::unique_ptr<juce::AudioFormatReader> reader(
+      wav.createReaderFor(file.createInputStream().release(), true));
+  if (reader == nullptr || reader->numChannels != 3)
+    return false;
+
+  data.setSize(3, (int)reader->lengthInSamples);
+  return reader->read(&data, 0, data.getNumSamples(), 0, true, true);
+}
+
+void printUsage() {
+  std::cout
+      << "Usage: dawdrey-golden record|verify <reference dir> [options]\n\n"
+         "  --filter <text>       Only cases whose description contains text\n"
+         "  --exact               Require bit-exact output everywhere\n"
+         "  --seconds <sec>       Render length (default 2)\n"
+         "  --onset-ms <ms>       Sample-exact onset window (default 10)\n"
+         "  --spectral-db <dB>    Max log-spectral distance (default 3)\n"
+         "  --level-db <dB>       Max RMS level difference (default 1)\n"
+         "  -j, --jobs <n>        Worker threads (default: one per core)\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  juce::ScopedJuceInitialiser_GUI juceInit; // Message manager for APVTS timers
+  juce::ArgumentList args(argc, argv);
+
+  if (args.size() < 2 || args.containsOption("--help|-h")) {
+    printUsage();
+    return args.containsOption("--help|-h") ? 0 : 1;
+  }
+
+  const bool record = args[0].text == "record";
+  if (!record && args[0].text != "verify") {
+    printUsage();
+    return 1;
+  }
+
+  const auto refDir = args[1].resolveAsFile();
+  if (record && !refDir.createDirectory()) {
+    std::cerr << "Cannot create " << refDir.getFullPathName() << std::endl;
+    return 1;
+  }
+
+  Options options;
+  options.exactOnly = args.containsOption("--exact");
+  options.filter = args.getValueForOption("--filter");
+  options.numThreads = args.getValueForOption("--jobs|-j").getIntValue();
+  if (args.containsOption("--seconds"))
+    options.seconds = args.getValueForOption("--seconds").getDoubleValue();
+  if (args.containsOption("--onset-ms"))
+    options.tolerance.onsetMs =
+        args.getValueForOption("--onset-ms").getDoubleValue();
+  if (args.containsOption("--spectral-db"))
+    options.tolerance.spectralDb =
+        args.getValueForOption("--spectral-db").getDoubleValue();
+  if (args.containsOption("--level-db"))
+    options.tolerance.levelDb =
+        args.getValueForOption("--level-db").getDoubleValue();
+
+  juce::StringArray presetNames{"Init"};
+  for (const auto &preset : getFactoryPresets())
+    presetNames.add(preset.name);
+
+  juce::Array<Case> cases;
+  for (const auto &name : presetNames)
+    for (const auto excitation : {Excitation::Impulse, Excitation::NoiseBurst,
+                                  Excitation::SineSweep})
+      for (const double sampleRate : options.sampleRates)
+        for (const int blockSize : options.blockSizes) {
+          Case c{name, excitation, sampleRate, blockSize};
+          if (options.filter.isEmpty() ||
+              c.getDescription().contains(options.filter))
+            cases.add(c);
+        }
+
+  juce::CriticalSection printLock;
+  std::atomic<int> failures{0};
+
+  juce::ThreadPool pool(options.numThreads > 0
+                            ? options.numThreads
+                            : juce::SystemStats::getNumCpus());
+
+  for (const auto &c : cases) {
+    pool.addJob([&, c] {
+      const auto rendered = renderCase(c, options);
+      const auto file = refDir.getChildFile(c.getFileName());
+
+      juce::String line;
+      bool ok = true;
+
+      if (record) {
+        ok = writeReference(file, rendered, c.sampleRate);
+        line = (ok ? "RECORDED " : "FAILED   ") + c.getDescription();
+      } else {
+        juce::AudioBuffer<float> reference;
+        if (!readReference(file, reference)) {
+          ok = false;
+          line = "MISSING  " + c.getDescription();
+        } else {
+          const auto output =
+              compareStage(reference, rendered, {0, 1}, c.sampleRate, options);
+          const auto loop =
+              compareStage(reference, rendered, {2}, c.sampleRate, options);
+          ok = output.pass && loop.pass;
+          line = juce::String(ok ? (output.exact && loop.exact ? "EXACT    "
+                                                               : "PASS     ")
+                                 : "FAIL     ") +
+                 c.getDescription() + "  [output: " + output.detail +
+                 "] [loop: " + loop.detail + "]";
+        }
+      }
+
+      if (!ok)
+        ++failures;
+
+      const juce::ScopedLock sl(printLock);
+      (ok ? std::cout : std::cerr) << line << std::endl;
+    });
+  }
+
+  while (pool.getNumJobs() > 0)
+    juce::Thread::sleep(10);
+
+  std::cout << cases.size() - failures.load() << "/" << cases.size()
+            << (record ? " references recorded" : " cases passed")
+            << std::endl;
+  return failures.load() == 0 ? 0 : 1;
+}
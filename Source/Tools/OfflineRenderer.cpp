@@ -0,0 +1,153 @@
+#include "OfflineRenderer.h"
+
+OfflineRenderer::Result OfflineRenderer::render(const Job &job) {
+  Result result;
+  const auto startTicks = juce::Time::getHighResolutionTicks();
+
+  juce::AudioFormatManager formatManager;
+  formatManager.registerBasicFormats();
+
+  std::unique_ptr<juce::AudioFormatReader> reader;
+  double sampleRate = job.sampleRate;
+  juce::int64 sourceLength = (juce::int64)(job.lengthSeconds * sampleRate);
+
+  if (job.input != juce::File()) {
+    reader.reset(formatManager.createReaderFor(job.input));
+    if (reader == nullptr) {
+      result.error = "Cannot read input: " + job.input.getFullPathName();
+      return result;
+    }
+    sampleRate = reader->sampleRate;
+    sourceLength = reader->lengthInSamples;
+  }
+
+  if (sampleRate <= 0.0) {
+    result.error = "Invalid sample rate";
+    return result;
+  }
+
+  const juce::int64 totalLength =
+      sourceLength + (juce::int64)(job.tailSeconds * sampleRate);
+  const int blockSize = juce::jmax(1, job.blockSize);
+
+  DawdreyAudioProcessor processor;
+  if (job.preset != juce::File() &&
+      !loadState(processor, job.preset, result.error))
+    return result;
+
+  processor.setNonRealtime(true);
+  processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+  processor.prepareToPlay(sampleRate, blockSize);
+
+  // createOutputStream() appends to existing files
+  job.output.deleteFile();
+  std::unique_ptr<juce::OutputStream> stream(job.output.createOutputStream());
+  if (stream == nullptr) {
+    result.error = "Cannot write output: " + job.output.getFullPathName();
+    return result;
+  }
+
+  juce::WavAudioFormat wav;
+  std::unique_ptr<juce::AudioFormatWriter> writer(
+      wav.createWriterFor(stream.get(), sampleRate, 2, job.bitDepth, {}, 0));
+  if (writer == nullptr) {
+    result.error = "Unsupported output format: " + juce::String(job.bitDepth) +
+                   " bit";
+    return result;
+  }
+  stream.release(); // Owned by the writer from here on
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::MidiBuffer midi;
+
+  for (juce::int64 pos = 0; pos < totalLength; pos += blockSize) {
+    const int numSamples =
+        (int)juce::jmin<juce::int64>(blockSize, totalLength - pos);
+    juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2,
+                                   numSamples);
+    block.clear();
+
+    if (reader != nullptr) {
+      if (pos < sourceLength)
+        reader->read(&block, 0,
+                     (int)juce::jmin<juce::int64>(numSamples,
+                                                  sourceLength - pos),
+                     pos, true, true);
+    } else if (job.excitation == Excitation::Impulse && pos == 0) {
+      block.setSample(0, 0, 1.0f);
+      block.setSample(1, 0, 1.0f);
+    }
+
+    midi.clear();
+    if (pos == 0 && job.midiNote >= 0)
+      midi.addEvent(
+          juce::MidiMessage::noteOn(1, juce::jlimit(0, 127, job.midiNote),
+                                    (juce::uint8)100),
+          0);
+
+    processor.processBlock(block, midi);
+
+    if (!writer->writeFromAudioSampleBuffer(block, 0, numSamples)) {
+      result.error = "Write failed: " + job.output.getFullPathName();
+      return result;
+    }
+  }
+
+  processor.releaseResources();
+  writer.reset();
+
+  result.ok = true;
+  result.samplesRendered = totalLength;
+  result.audioSeconds = (double)totalLength / sampleRate;
+  result.wallSeconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - startTicks);
+  return result;
+}
+
+juce::Array<OfflineRenderer::Result> OfflineRenderer::renderBatch(
+    const juce::Array<Job> &jobs, int numThreads,
+    std::function<void(int jobIndex, const Result &)> onJobFinished) {
+  juce::Array<Result> results;
+  results.resize(jobs.size());
+
+  juce::ThreadPool pool(numThreads > 0 ? numThreads
+                                       : juce::SystemStats::getNumCpus());
+
+  for (int i = 0; i < jobs.size(); ++i) {
+    pool.addJob([&, i] {
+      // Each worker writes only its own slot, the array is never resized
+      results.getReference(i) = render(jobs.getReference(i));
+      if (onJobFinished)
+        onJobFinished(i, results.getReference(i));
+    });
+  }
+
+  while (pool.getNumJobs() > 0)
+    juce::Thread::sleep(10);
+
+  return results;
+}
+
+bool OfflineRenderer::loadState(DawdreyAudioProcessor &processor,
+                                const juce::File &file, juce::String &error) {
+  juce::MemoryBlock data;
+  if (!file.loadFileAsData(data)) {
+    error = "Cannot read preset: " + file.getFullPathName();
+    return false;
+  }
+
+  // Host state is the binary format (or, from older versions, JUCE's
+  // binary wrapped XML) and loads as in a host; preset files are plain XML
+  // and load as in the editor
+  if (processor.loadHostState(data.getData(), (int)data.getSize()))
+    return true;
+
+  std::unique_ptr<juce::XmlElement> xml(juce::parseXML(data.toString()));
+  if (xml == nullptr || !xml->hasTagName(processor.apvts.state.getType())) {
+    error = "Not a Dawdrey preset or state: " + file.getFullPathName();
+    return false;
+  }
+
+  processor.presetManager->replaceState(juce::ValueTree::fromXml(*xml));
+  return true;
+}
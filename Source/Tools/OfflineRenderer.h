@@ -0,0 +1,52 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include <JuceHeader.h>
+
+// Renders audio through DawdreyAudioProcessor without an editor or audio
+// device, as fast as the machine allows. Used by the dawdrey-render CLI for
+// regression renders, preset previews and server-side bounces.
+class OfflineRenderer {
+public:
+  // Signal fed into the processor when no input file is given
+  enum class Excitation { Silence, Impulse };
+
+  struct Job {
+    juce::File preset; // Preset XML or getStateInformation() blob, optional
+    juce::File input;  // Any format AudioFormatManager reads, optional
+    juce::File output; // Always written as WAV
+
+    Excitation excitation = Excitation::Silence;
+    double sampleRate = 48000.0; // Ignored when rendering an input file
+    double lengthSeconds = 10.0; // Excitation length, ignored with an input
+    double tailSeconds = 0.0;    // Silence appended after the input
+    int blockSize = 512;
+    int bitDepth = 24;
+    int midiNote = -1; // Note-on at sample 0 (instrument mode), -1 = none
+  };
+
+  struct Result {
+    bool ok = false;
+    juce::String error;
+    juce::int64 samplesRendered = 0;
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+
+    double getRealtimeFactor() const {
+      return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0;
+    }
+  };
+
+  // Renders one job on the calling thread with its own processor instance.
+  static Result render(const Job &job);
+
+  // Renders all jobs on a pool of numThreads workers (0 = one per core).
+  // onJobFinished is called from the worker threads as jobs complete.
+  static juce::Array<Result>
+  renderBatch(const juce::Array<Job> &jobs, int numThreads,
+              std::function<void(int jobIndex, const Result &)> onJobFinished);
+
+  // Applies a preset XML or a binary state blob to the processor.
+  static bool loadState(DawdreyAudioProcessor &processor,
+                        const juce::File &file, juce::String &error);
+};
@@ -0,0 +1,103 @@
+// dawdrey-pool-stress: RealtimeWorkerPool stress test.
+//
+// Calls Run() back to back with alternating task counts and contexts, so
+// workers that wake late overlap the start of the next run, and checks that
+// every task of every run ran exactly once, against its own run's context,
+// before Run() returned. Exits with 1 on the first failure.
+//
+//   dawdrey-pool-stress                  (50000 runs, 3 workers)
+//   dawdrey-pool-stress -n 1000000 -w 3
+
+#include "RealtimeWorkerPool.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace infrasonic;
+
+namespace {
+
+constexpr int kMaxTasks = 32;
+
+struct Batch {
+    int count = 0;
+    std::atomic<int> runs[kMaxTasks];
+    std::atomic<int> out_of_range{0};
+};
+
+void Task(void *context, int index)
+{
+    auto *batch = static_cast<Batch *>(context);
+    if (index < 0 || index >= batch->count) {
+        batch->out_of_range.fetch_add(1);
+        return;
+    }
+    // Uneven task lengths spread the workers' finishing times
+    volatile int sink = 0;
+    for (int i = 0; i < (index % 5) * 50; i++) {
+        sink = sink + i;
+    }
+    batch->runs[index].fetch_add(1);
+}
+
+void printUsage()
+{
+    std::printf("Usage: dawdrey-pool-stress [options]\n\n"
+                "  -n, --runs <n>      Runs to check (default 50000)\n"
+                "  -w, --workers <n>   Worker threads (default 3)\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    long num_runs = 50000;
+    // More workers than cores is fine, and makes late wake-ups likelier
+    int num_workers = 3;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if ((arg == "-n" || arg == "--runs") && i + 1 < argc) {
+            num_runs = std::atol(argv[++i]);
+        } else if ((arg == "-w" || arg == "--workers") && i + 1 < argc) {
+            num_workers = std::atoi(argv[++i]);
+        } else {
+            printUsage();
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+
+    RealtimeWorkerPool pool(num_workers);
+    // Short and long runs alternate, so a late worker from a short run sees
+    // a larger task count published for the next one
+    static constexpr int kCounts[] = {2, kMaxTasks, 3, 17, 5, kMaxTasks - 1};
+    Batch batches[2];
+
+    for (long run = 0; run < num_runs; run++) {
+        Batch &batch = batches[run & 1];
+        batch.count = kCounts[run % (sizeof(kCounts) / sizeof(kCounts[0]))];
+        for (auto &runs : batch.runs) {
+            runs.store(0, std::memory_order_relaxed);
+        }
+        batch.out_of_range.store(0, std::memory_order_relaxed);
+
+        pool.Run(Task, &batch, batch.count);
+
+        if (batch.out_of_range.load() != 0) {
+            std::printf("run %ld: task index outside its run's count\n", run);
+            return 1;
+        }
+        for (int t = 0; t < batch.count; t++) {
+            const int n = batch.runs[t].load();
+            if (n != 1) {
+                std::printf("run %ld: task %d of %d ran %d times\n", run, t, batch.count, n);
+                return 1;
+            }
+        }
+    }
+
+    std::printf("%ld runs on %d workers: every task ran exactly once\n", num_runs,
+                pool.GetNumWorkers());
+    return 0;
+}
@@ -0,0 +1,162 @@
+// dawdrey-render: offline, faster than real time rendering through
+// DawdreyAudioProcessor without an editor or audio device.
+//
+//   dawdrey-render -p preset.xml -i input.wav -o output.wav
+//   dawdrey-render -p state.bin -e impulse -l 8 -o preview.wav
+//   dawdrey-render --batch jobs.tsv -j 8
+//
+// A batch file lists one job per line as tab separated fields:
+//   <preset or -> <input file, "impulse" or "silence"> <output file>
+// Relative paths are resolved against the batch file's directory. Lines
+// starting with '#' are ignored. All other options apply to every job.
+
+#include "OfflineRenderer.h"
+#include <JuceHeader.h>
+#include <iostream>
+
+namespace {
+
+void printUsage() {
+  std::cout
+      << "Usage: dawdrey-render [options] -o <output.wav>\n"
+         "       dawdrey-render [options] --batch <jobs.tsv>\n\n"
+         "  -o, --output <file>   Output WAV\n"
+         "  -p, --preset <file>   Preset XML or saved plugin state\n"
+         "  -i, --input <file>    Audio file streamed through the processor\n"
+         "  -e, --excite <type>   impulse|silence when there is no input "
+         "(default impulse)\n"
+         "  -l, --length <sec>    Excitation length (default 10)\n"
+         "  -t, --tail <sec>      Silence appended after the input "
+         "(default 0)\n"
+         "  -r, --rate <hz>       Sample rate without input (default 48000)\n"
+         "  -b, --block <n>       Block size (default 512)\n"
+         "  -n, --note <0-127>    MIDI note-on at the start (instrument "
+         "mode)\n"
+         "      --bits <n>        Output bit depth 16|24|32 (default 24)\n"
+         "      --batch <file>    Render a list of jobs in parallel\n"
+         "  -j, --jobs <n>        Worker threads for --batch (default: one "
+         "per core)\n";
+}
+
+juce::File resolve(const juce::String &path, const juce::File &base) {
+  return juce::File::isAbsolutePath(path) ? juce::File(path)
+                                          : base.getChildFile(path);
+}
+
+void printResult(const juce::String &name,
+                 const OfflineRenderer::Result &result) {
+  if (result.ok)
+    std::cout << name << ": " << juce::String(result.audioSeconds, 2)
+              << " s in " << juce::String(result.wallSeconds, 2) << " s ("
+              << juce::String(result.getRealtimeFactor(), 1) << "x realtime)"
+              << std::endl;
+  else
+    std::cerr << name << ": " << result.error << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  juce::ScopedJuceInitialiser_GUI juceInit; // Message manager for APVTS timers
+  juce::ArgumentList args(argc, argv);
+
+  if (args.size() == 0 || args.containsOption("--help|-h")) {
+    printUsage();
+    return 0;
+  }
+
+  const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+  OfflineRenderer::Job defaults;
+  const auto excite = args.getValueForOption("--excite|-e");
+  defaults.excitation = excite == "silence"
+                            ? OfflineRenderer::Excitation::Silence
+                            : OfflineRenderer::Excitation::Impulse;
+  if (args.containsOption("--length|-l"))
+    defaults.lengthSeconds =
+        args.getValueForOption("--length|-l").getDoubleValue();
+  if (args.containsOption("--tail|-t"))
+    defaults.tailSeconds = args.getValueForOption("--tail|-t").getDoubleValue();
+  if (args.containsOption("--rate|-r"))
+    defaults.sampleRate = args.getValueForOption("--rate|-r").getDoubleValue();
+  if (args.containsOption("--block|-b"))
+    defaults.blockSize = args.getValueForOption("--block|-b").getIntValue();
+  if (args.containsOption("--note|-n"))
+    defaults.midiNote = args.getValueForOption("--note|-n").getIntValue();
+  if (args.containsOption("--bits"))
+    defaults.bitDepth = args.getValueForOption("--bits").getIntValue();
+
+  if (args.containsOption("--batch")) {
+    const auto listFile = resolve(args.getValueForOption("--batch"), cwd);
+    const auto base = listFile.getParentDirectory();
+
+    juce::StringArray lines;
+    listFile.readLines(lines);
+
+    juce::Array<OfflineRenderer::Job> jobs;
+    for (const auto &rawLine : lines) {
+      const auto line = rawLine.trim();
+      if (line.isEmpty() || line.startsWithChar('#'))
+        continue;
+
+      const auto fields = juce::StringArray::fromTokens(line, "\t", "\"");
+      if (fields.size() != 3) {
+        std::cerr << "Skipping malformed batch line: " << line << std::endl;
+        continue;
+      }
+
+      auto job = defaults;
+      if (fields[0] != "-")
+        job.preset = resolve(fields[0], base);
+      if (fields[1] == "impulse")
+        job.excitation = OfflineRenderer::Excitation::Impulse;
+      else if (fields[1] == "silence")
+        job.excitation = OfflineRenderer::Excitation::Silence;
+      else
+        job.input = resolve(fields[1], base);
+      job.output = resolve(fields[2], base);
+      jobs.add(job);
+    }
+
+    juce::CriticalSection printLock;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    const auto results = OfflineRenderer::renderBatch(
+        jobs, args.getValueForOption("--jobs|-j").getIntValue(),
+        [&](int index, const OfflineRenderer::Result &result) {
+          const juce::ScopedLock sl(printLock);
+          printResult(jobs.getReference(index).output.getFileName(), result);
+        });
+
+    int failures = 0;
+    double audioSeconds = 0.0;
+    for (const auto &result : results) {
+      failures += result.ok ? 0 : 1;
+      audioSeconds += result.audioSeconds;
+    }
+
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - startTicks);
+    std::cout << results.size() - failures << "/" << results.size()
+              << " jobs rendered, " << juce::String(audioSeconds, 1)
+              << " s of audio in " << juce::String(wallSeconds, 2) << " s"
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+  }
+
+  if (!args.containsOption("--output|-o")) {
+    printUsage();
+    return 1;
+  }
+
+  auto job = defaults;
+  job.output = resolve(args.getValueForOption("--output|-o"), cwd);
+  if (args.containsOption("--preset|-p"))
+    job.preset = resolve(args.getValueForOption("--preset|-p"), cwd);
+  if (args.containsOption("--input|-i"))
+    job.input = resolve(args.getValueForOption("--input|-i"), cwd);
+
+  const auto result = OfflineRenderer::render(job);
+  printResult(job.output.getFileName(), result);
+  return result.ok ? 0 : 1;
+}
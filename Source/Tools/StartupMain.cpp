@@ -0,0 +1,135 @@
+// dawdrey-startup: instance startup benchmark.
+//
+// Creates processors the way a host opening a session does and times each
+// phase on its own: construction, the first prepareToPlay and the first
+// processBlock. Instances stay alive until the end, as in a session. With
+// --scan each instance is constructed and destroyed straight away, like a
+// host plugin scan. Prints total, mean, median and max per phase, and for
+// construct + prepare + first block together, as JSON:
+//
+//   dawdrey-startup                      (100 instances, 48 kHz, 512)
+//   dawdrey-startup -n 200 -r 96000 -b 256
+//   dawdrey-startup --scan
+//
+// Compare Release builds on the same machine.
+
+#include "PluginProcessor.h"
+#include <JuceHeader.h>
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+  std::cout << "Usage: dawdrey-startup [options]\n\n"
+               "  -n, --instances <n>   Instances to create (default 100)\n"
+               "  -r, --rate <hz>       Sample rate (default 48000)\n"
+               "  -b, --block <n>       Block size (default 512)\n"
+               "      --scan            Construct and destroy only\n"
+               "  -o, --output <file>   Also write the JSON here\n";
+}
+
+double nowMs() { return juce::Time::getMillisecondCounterHiRes(); }
+
+juce::var summarise(std::vector<double> ms) {
+  auto *summary = new juce::DynamicObject();
+  if (!ms.empty()) {
+    std::sort(ms.begin(), ms.end());
+    const double total = std::accumulate(ms.begin(), ms.end(), 0.0);
+    summary->setProperty("total_ms", total);
+    summary->setProperty("mean_ms", total / (double)ms.size());
+    summary->setProperty("median_ms", ms[ms.size() / 2]);
+    summary->setProperty("max_ms", ms.back());
+  }
+  return summary;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  juce::ScopedJuceInitialiser_GUI juceInit; // Message manager for APVTS timers
+  juce::ArgumentList args(argc, argv);
+
+  if (args.containsOption("--help|-h")) {
+    printUsage();
+    return 0;
+  }
+
+  int numInstances = 100;
+  double sampleRate = 48000.0;
+  int blockSize = 512;
+  if (args.containsOption("--instances|-n"))
+    numInstances = juce::jmax(
+        1, args.getValueForOption("--instances|-n").getIntValue());
+  if (args.containsOption("--rate|-r"))
+    sampleRate = args.getValueForOption("--rate|-r").getDoubleValue();
+  if (args.containsOption("--block|-b"))
+    blockSize =
+        juce::jmax(1, args.getValueForOption("--block|-b").getIntValue());
+  const bool scanOnly = args.containsOption("--scan");
+
+  std::vector<double> constructMs, prepareMs, firstBlockMs, startupMs;
+  std::vector<std::unique_ptr<DawdreyAudioProcessor>> instances;
+  instances.reserve((size_t)numInstances);
+
+  juce::AudioBuffer<float> buffer(2, blockSize);
+  juce::MidiBuffer midi;
+
+  const double start = nowMs();
+  for (int i = 0; i < numInstances; ++i) {
+    double t = nowMs();
+    auto processor = std::make_unique<DawdreyAudioProcessor>();
+    if (scanOnly) {
+      processor.reset();
+      constructMs.push_back(nowMs() - t);
+      continue;
+    }
+    constructMs.push_back(nowMs() - t);
+
+    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+    t = nowMs();
+    processor->prepareToPlay(sampleRate, blockSize);
+    prepareMs.push_back(nowMs() - t);
+
+    buffer.clear();
+    buffer.setSample(0, 0, 1.0f);
+    t = nowMs();
+    processor->processBlock(buffer, midi);
+    firstBlockMs.push_back(nowMs() - t);
+    startupMs.push_back(constructMs.back() + prepareMs.back() +
+                        firstBlockMs.back());
+
+    instances.push_back(std::move(processor));
+  }
+  const double wallMs = nowMs() - start;
+  instances.clear();
+
+  auto *result = new juce::DynamicObject();
+  result->setProperty("mode", scanOnly ? "scan" : "session");
+  result->setProperty("instances", numInstances);
+  result->setProperty("sample_rate", sampleRate);
+  result->setProperty("block_size", blockSize);
+  result->setProperty("wall_ms", wallMs);
+  result->setProperty(scanOnly ? "construct_destroy" : "construct",
+                      summarise(constructMs));
+  if (!scanOnly) {
+    result->setProperty("prepare", summarise(prepareMs));
+    result->setProperty("first_block", summarise(firstBlockMs));
+    result->setProperty("startup", summarise(startupMs));
+  }
+
+  const auto json = juce::JSON::toString(juce::var(result));
+  std::cout << json << std::endl;
+
+  if (args.containsOption("--output|-o")) {
+    const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(
+        args.getValueForOption("--output|-o"));
+    if (!file.replaceWithText(json)) {
+      std::cerr << "Cannot write " << file.getFullPathName() << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}